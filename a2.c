@@ -17,27 +17,29 @@
 #include "resources.h"
 #include "utilities.h"
 #include "shared_data.h"
+#include "elimination.h"
+#include "wal.h"
+#include "server.h"
+#include "perf_counters.h"
+#include "slo.h"
+#include "stats.h"
+#include "reporter.h"
+#include "autotune.h"
+#include "regress.h"
+#include "schedule.h"
+#include "delegation.h"
+#include "history.h"
+#include "replication.h"
 #include "thread_operations.h"
 
 /**
- * @brief   Prints final state of the shared data and thread counts.
- * 
- * @details Accesses shared data and prints its state, including the number of 
- *          reader, incrementer, and decrementer threads created.
- * 
- * @param   num_incrementers Total incrementer threads.
- * @param   num_decrementers Total decrementer threads.
- * @param   num_readers Total reader threads.
+ * @brief   Prints the final state of the shared data.
  */
-void print_result(int num_incrementers,int num_decrementers, int num_readers)
+void print_shared_state()
 {
     /* Access the shared data */
     SharedData *data = get_shared_data();
 
-    /* Print out the thread information. */
-    printf("There were %d readers, %d incrementers and %d decrementers\n",
-            num_readers, num_incrementers, num_decrementers);
-
     /* Display the final state of the shared data. */
     printf("The final state of the data is:\n"
             "\tlast incrementer %d\n"
@@ -48,6 +50,75 @@ void print_result(int num_incrementers,int num_decrementers, int num_readers)
             data->last_decr_id, 
             data->num_writers, 
             data->sum);
+    if (get_options()->elimination) {
+        printf("\teliminated pairs %lu\n", eliminated_pairs());
+    }
+    if (wal_enabled()) {
+        unsigned long records, commits;
+        wal_stats(&records, &commits);
+        printf("\tlogged records %lu in %lu group commits\n",
+                records, commits);
+    }
+    if (history_enabled()) {
+        print_history_report();
+    }
+    if (replicas_enabled()) {
+        print_replica_report();
+    }
+}
+
+/**
+ * @brief   Prints final state of the shared data and thread counts.
+ * 
+ * @details Accesses shared data and prints its state, including the number of 
+ *          reader, incrementer, and decrementer threads created.
+ * 
+ * @param   num_incrementers Total incrementer threads.
+ * @param   num_decrementers Total decrementer threads.
+ * @param   num_readers Total reader threads.
+ */
+void print_result(int num_incrementers,int num_decrementers, int num_readers)
+{
+    /* Print out the thread information. */
+    printf("There were %d readers, %d incrementers and %d decrementers\n",
+            num_readers, num_incrementers, num_decrementers);
+
+    print_shared_state();
+
+    /* Report how many operations met their deadline. */
+    if (get_options()->deadline_us > 0) {
+        print_slo_report(get_options()->deadline_us);
+    }
+
+    /* Report what the hardware saw, per completed operation. */
+    if (get_options()->perf_counters) {
+        StatsTotals totals;
+        stats_totals(&totals);
+        print_perf_counters((long)(totals.ops[0] + totals.ops[1] +
+                                   totals.ops[2]));
+    }
+}
+
+/**
+ * @brief   Serves the shared data over a socket instead of running threads.
+ * 
+ * @param   socket_path Filesystem path to listen on.
+ */
+void serve(const char* socket_path)
+{
+    unsigned long requests, connections;
+
+    /* The server thread is the only client of the owner thread */
+    if (get_options()->writer_lock == WRITER_LOCK_DELEGATE) {
+        start_delegation(1);
+    }
+    run_server(socket_path);
+    stop_delegation();
+
+    server_stats(&requests, &connections);
+    printf("Served %lu requests over %lu connections\n",
+            requests, connections);
+    print_shared_state();
 }
 
 /**
@@ -65,17 +136,18 @@ void print_result(int num_incrementers,int num_decrementers, int num_readers)
  */
 int main(int argc, char *argv[])
 {
-    int max_threads = DEFAULT_THREADS; /* Number of threads to create       */
+    Options* options;           /* Parsed command line options              */
+    int max_threads;            /* Number of threads to create              */
     int num_incrementers;       /* Number of incrementer threads.           */
     int num_decrementers;       /* Number of decrementer threads.           */
     int num_readers;            /* Number of reader threads.                */
-    int count = 0;              /* Count of all threads created so far      */
 
     /* Parse user-provided arguments. */
-    parse_args(argc, argv, &max_threads);
+    options = parse_args(argc, argv);
+    max_threads = options->num_threads;
 
     /* Initialize necessary resources. */
-    Resources* rsc = init_resources();
+    init_resources();
 
     /* Allocate memory space for the threads. */
     alloc_threads(max_threads);
@@ -83,29 +155,120 @@ int main(int argc, char *argv[])
     /* Initialize the shared data structure. */
     init_shared_data();
 
-    /* Seed the random number generator. */
-    srand(time(NULL));
+    /* Keep a bounded history of the sum, if requested. */
+    if (options->history_capacity > 0) {
+        history_init(options->history_capacity);
+    }
+
+    /* Recover the persisted state, if persistence is enabled. */
+    if (options->wal_path) {
+        wal_open(options->wal_path);
+    }
+
+    /* In server mode, other processes drive the operations. */
+    if (options->socket_path) {
+        serve(options->socket_path);
+        wal_close();
+        cleanup();
+        exit(EXIT_SUCCESS);
+    }
+
+    /* In autotune mode, calibration trials replace the normal run. */
+    if (options->tune_path) {
+        run_autotune(options->tune_path);
+        wal_close();
+        cleanup();
+        exit(EXIT_SUCCESS);
+    }
+
+    /* In regression mode, the fixed suite replaces the normal run. */
+    if (options->baseline_path) {
+        int regressions = 0;
+        if (options->record_baseline) {
+            record_baseline(options->baseline_path);
+        } else {
+            regressions = check_baseline(options->baseline_path,
+                                         options->regress_threshold);
+        }
+        wal_close();
+        cleanup();
+        exit(regressions ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    /* Seed the random number generator, keeping the seed for reuse. */
+    if (options->seed < 0) {
+        options->seed = time(NULL);
+    }
+    srand((unsigned int)options->seed);
 
     /* Randomly decide the number of threads for each type. */
     num_incrementers = rand() % (max_threads / 2) + 1;
     num_decrementers = rand() % (max_threads / 2) + 1;
     num_readers = max_threads - (num_incrementers + num_decrementers);
 
-    /* Create threads for incrementers, decrementers, and readers. */
-    count = create_threads(rsc->threads, max_threads, count, num_incrementers,
-                            incrementer, "incrementer");
-    count = create_threads(rsc->threads, max_threads, count, num_decrementers,
-                            decrementer, "decrementer");
-    count = create_threads(rsc->threads, max_threads, count, num_readers,
-                            reader, "reader");
+    /* In simulation mode, a model of the lock protocol replaces the run. */
+    if (options->replay_path || options->schedule_scenario) {
+        if (options->replay_path) {
+            replay_schedule(options->replay_path);
+        } else {
+            simulate_schedules(options->schedule_scenario, num_incrementers,
+                               num_decrementers, num_readers,
+                               options->ops_per_thread, options->seed);
+        }
+        wal_close();
+        cleanup();
+        exit(EXIT_SUCCESS);
+    }
 
-    /* Wait for all the threads to finish execution. */
-    join_threads(rsc->threads, count);
+    /* Give every thread a counter slot, timing locks only when reported. */
+    stats_init(max_threads, options->report_ms > 0);
+    if (options->report_ms > 0) {
+        start_reporter(options->report_ms, options->report_json);
+    }
+
+    /* Start counting before the threads exist so they inherit counters. */
+    if (options->perf_counters) {
+        perf_begin();
+    }
+
+    /* Serve reads from replicas following the primary, if requested. */
+    if (options->replicas > 0) {
+        start_replicas(options->replicas);
+    }
+
+    /* In delegation mode, the owner thread serves every other thread. */
+    if (options->writer_lock == WRITER_LOCK_DELEGATE) {
+        start_delegation(max_threads);
+    }
+
+    /* Record the order of lock events, if requested. */
+    if (options->trace_path) {
+        schedule_record_begin(SCHED_TRACE_CAPACITY);
+    }
+
+    /* Run the threads, for the requested time in duration mode. */
+    run_workers(num_incrementers, num_decrementers, num_readers,
+                options->duration_sec * 1000L);
+    if (options->trace_path) {
+        schedule_record_end(options->trace_path);
+    }
+    stop_delegation();
+    stop_replicas();
+    if (options->perf_counters) {
+        perf_end();
+    }
+    stop_reporter();
 
     /* Display the final state of the system. */
     print_result(num_incrementers, num_decrementers, num_readers);
 
+    /* Write a final checkpoint and close the log. */
+    wal_close();
+
     /* Clean up allocated resources and exit. */
+    destroy_stats();
+    destroy_history();
+    destroy_replicas();
     cleanup();
     exit(EXIT_SUCCESS);
 } 
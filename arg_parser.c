@@ -5,47 +5,366 @@
  * @version 1.0
  *
  * @brief   Provides parsing of command line arguments.
- * 
+ *
  * @details This file implements the function to parse the command line
- *          arguments for the program. It checks argument validity and sets 
- *          the number of threads to be used.
+ *          arguments for the program. It checks argument validity and sets
+ *          the number of threads and the synchronization options to be used.
  */
 
 #include <dirent.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "arg_parser.h"
 #include "common.h"
 #include "utilities.h"
 
+#define USAGE "Usage: %s [-qePj] [-n ops] [-d seconds] [-r interval_ms] " \
+              "[-s seed] [-H entries] [-R replicas] " \
+              "[-t deadline_us] [-w sem|mcs|delegate] " \
+              "[-b none|exp|prop] [-a none|compact|spread] " \
+              "[-A config] [-L p99_us] [-C config] [-B baseline] " \
+              "[-G baseline] [-T percent] [-E trace] [-D scenario] " \
+              "[-Y trace] [-p path] [-S socket] [num_threads]"
+#define OPTSTRING "qePjn:d:r:s:H:R:t:w:b:a:A:L:C:B:G:T:E:D:Y:p:S:"
+#define CONFIG_LINE 64
+
+static Options options = {
+    .num_threads = DEFAULT_THREADS,
+    .ops_per_thread = DEFAULT_OPS,
+    .writer_lock = WRITER_LOCK_SEM,
+    .backoff = BACKOFF_NONE,
+    .quiet = 0,
+    .elimination = 0,
+    .wal_path = NULL,
+    .socket_path = NULL,
+    .perf_counters = 0,
+    .deadline_us = 0,
+    .duration_sec = 0,
+    .report_ms = 0,
+    .report_json = 0,
+    .affinity = AFFINITY_NONE,
+    .tune_path = NULL,
+    .p99_limit_us = DEFAULT_P99_LIMIT_US,
+    .seed = -1,
+    .history_capacity = 0,
+    .replicas = 0,
+    .baseline_path = NULL,
+    .record_baseline = 0,
+    .regress_threshold = DEFAULT_REGRESS_THRESHOLD,
+    .trace_path = NULL,
+    .schedule_scenario = NULL,
+    .replay_path = NULL
+};
+
+static const char* const writer_lock_names[] = { "sem", "mcs", "delegate" };
+static const char* const backoff_names[] = { "none", "exp", "prop" };
+static const char* const affinity_names[] = { "none", "compact", "spread" };
+
+/**
+ * @brief   Reports an invalid argument along with the usage line and exits.
+ *
+ * @param   program Name the program was invoked with.
+ * @param   reason  Description of what was wrong.
+ */
+static void usage_error(const char* program, const char* reason)
+{
+    char errorMsg[MAX_STRING * 4];
+    snprintf(errorMsg, sizeof(errorMsg), "%s\n" USAGE, reason, program);
+    handle_error(errorMsg);
+}
+
+/**
+ * @brief   Looks a setting name up in a table of names.
+ *
+ * @param   name  Name to look up.
+ * @param   names Table of names, indexed by setting value.
+ * @param   count Number of names in the table.
+ *
+ * @return  Index of the name, or -1 if not recognised.
+ */
+static int parse_name(const char* name, const char* const names[], int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief   Parses a writer lock name.
+ *
+ * @param   name One of "sem", "mcs" or "delegate".
+ *
+ * @return  Matching WRITER_LOCK_* value, or -1 if not recognised.
+ */
+static int parse_writer_lock(const char* name)
+{
+    return parse_name(name, writer_lock_names, 3);
+}
+
+/**
+ * @brief   Parses an affinity layout name.
+ *
+ * @param   name One of "none", "compact" or "spread".
+ *
+ * @return  Matching AFFINITY_* value, or -1 if not recognised.
+ */
+static int parse_affinity(const char* name)
+{
+    return parse_name(name, affinity_names, 3);
+}
+
+/**
+ * @brief   Applies one setting from a configuration file.
+ *
+ * @param   key   Setting name.
+ * @param   value Setting value.
+ *
+ * @return  1 on success, 0 if the key or value is invalid.
+ */
+static int apply_setting(const char* key, const char* value)
+{
+    if (strcmp(key, "threads") == 0) {
+        options.num_threads = atoi(value);
+        return options.num_threads >= MINIMUM_THREADS;
+    } else if (strcmp(key, "writer_lock") == 0) {
+        options.writer_lock = parse_writer_lock(value);
+        return options.writer_lock >= 0;
+    } else if (strcmp(key, "backoff") == 0) {
+        return parse_backoff(value, &options.backoff);
+    } else if (strcmp(key, "affinity") == 0) {
+        options.affinity = parse_affinity(value);
+        return options.affinity >= 0;
+    }
+    return 0;
+}
+
 /**
  * @brief   Parses the command line arguments.
- * 
- * @details Checks argument count and validity. If arguments are invalid, 
+ *
+ * @details Checks option and argument validity. If arguments are invalid,
  *          prints an error message and exits.
- * 
+ *
  * @param   argc Count of command line arguments.
  * @param   argv Array of command line arguments.
- * @param   num_threads Pointer to the number of threads to be used.
+ *
+ * @return  Pointer to the parsed options.
  */
-void parse_args(int argc, char* argv[], int* num_threads)
+Options* parse_args(int argc, char* argv[])
 {
+    int opt;
+
+    while ((opt = getopt(argc, argv, OPTSTRING)) != -1) {
+        switch (opt) {
+        case 'q':
+            options.quiet = 1;
+            break;
+        case 'e':
+            options.elimination = 1;
+            break;
+        case 'P':
+            options.perf_counters = 1;
+            break;
+        case 'j':
+            options.report_json = 1;
+            break;
+        case 'n':
+            if ((options.ops_per_thread = atoi(optarg)) < 1) {
+                usage_error(argv[0], "Operations per thread must be positive.");
+            }
+            break;
+        case 'd':
+            if ((options.duration_sec = atoi(optarg)) < 1) {
+                usage_error(argv[0], "Duration must be positive.");
+            }
+            break;
+        case 'r':
+            if ((options.report_ms = atol(optarg)) < 1) {
+                usage_error(argv[0], "Report interval must be positive.");
+            }
+            break;
+        case 's':
+            if ((options.seed = atol(optarg)) < 0) {
+                usage_error(argv[0], "Seed must not be negative.");
+            }
+            break;
+        case 'H':
+            if ((options.history_capacity = atol(optarg)) < 1) {
+                usage_error(argv[0], "History capacity must be positive.");
+            }
+            break;
+        case 'R':
+            if ((options.replicas = atoi(optarg)) < 1) {
+                usage_error(argv[0], "Replica count must be positive.");
+            }
+            break;
+        case 't':
+            if ((options.deadline_us = atol(optarg)) < 1) {
+                usage_error(argv[0], "Deadline must be positive.");
+            }
+            break;
+        case 'w':
+            if ((options.writer_lock = parse_writer_lock(optarg)) < 0) {
+                usage_error(argv[0], "Unknown writer lock.");
+            }
+            break;
+        case 'b':
+            if (!parse_backoff(optarg, &options.backoff)) {
+                usage_error(argv[0], "Unknown backoff policy.");
+            }
+            break;
+        case 'a':
+            if ((options.affinity = parse_affinity(optarg)) < 0) {
+                usage_error(argv[0], "Unknown affinity layout.");
+            }
+            break;
+        case 'A':
+            options.tune_path = optarg;
+            break;
+        case 'L':
+            if ((options.p99_limit_us = atol(optarg)) < 1) {
+                usage_error(argv[0], "Latency limit must be positive.");
+            }
+            break;
+        case 'C':
+            load_config(optarg);
+            break;
+        case 'B':
+            options.baseline_path = optarg;
+            options.record_baseline = 1;
+            break;
+        case 'G':
+            options.baseline_path = optarg;
+            options.record_baseline = 0;
+            break;
+        case 'T':
+            if ((options.regress_threshold = atof(optarg)) <= 0.0) {
+                usage_error(argv[0], "Regression threshold must be positive.");
+            }
+            break;
+        case 'E':
+            options.trace_path = optarg;
+            break;
+        case 'D':
+            options.schedule_scenario = optarg;
+            break;
+        case 'Y':
+            options.replay_path = optarg;
+            break;
+        case 'p':
+            options.wal_path = optarg;
+            break;
+        case 'S':
+            options.socket_path = optarg;
+            break;
+        default:
+            usage_error(argv[0], "Invalid option.");
+        }
+    }
+
+    /* Lock events are only traced for the semaphore and MCS protocols */
+    if (options.trace_path &&
+        (options.writer_lock == WRITER_LOCK_DELEGATE || options.replicas)) {
+        usage_error(argv[0], "Lock tracing cannot be combined with "
+                    "delegation or replicas.");
+    }
+
     /* Check for excess arguments */
-    if (argc > 2) {
-        char errorMsg[MAX_STRING];
-        snprintf(errorMsg, sizeof(errorMsg),
-                "Invalid number of arguments.\n"
-                "Usage: %s [num_threads]", argv[0]);
-        handle_error(errorMsg);
+    if (argc - optind > 1) {
+        usage_error(argv[0], "Invalid number of arguments.");
 
     /* Check if the number of threads specified is below the minimum */
-    } else if (argc == 2 && (*num_threads = atoi(argv[1])) < MINIMUM_THREADS) {
+    } else if (argc - optind == 1 &&
+               (options.num_threads = atoi(argv[optind])) < MINIMUM_THREADS) {
         char errorMsg[MAX_STRING];
         snprintf(errorMsg, sizeof(errorMsg),
                 "Invalid number of threads.\n"
                 "Must be greater than %d.", MINIMUM_THREADS);
         handle_error(errorMsg);
     }
+
+    return &options;
+}
+
+/**
+ * @brief   Loads a configuration file saved by the autotuner.
+ *
+ * @details Settings from the file replace those given earlier on the
+ *          command line; options given after it override the file.
+ *
+ * @param   path Configuration file to load.
+ */
+void load_config(const char* path)
+{
+    char line[CONFIG_LINE], key[CONFIG_LINE], value[CONFIG_LINE];
+    char errorMsg[MAX_STRING * 2];
+    int line_number = 0;
+    FILE* file = fopen(path, "r");
+
+    if (!file) {
+        snprintf(errorMsg, sizeof(errorMsg), "Error opening config %s: %s",
+                path, strerror(errno));
+        handle_error(errorMsg);
+    }
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == '#' || line[strspn(line, " \t\n")] == '\0') {
+            continue;
+        }
+        if (sscanf(line, " %63[^= ] = %63s", key, value) != 2 ||
+            !apply_setting(key, value)) {
+            fclose(file);
+            snprintf(errorMsg, sizeof(errorMsg),
+                    "Invalid setting on line %d of config %s",
+                    line_number, path);
+            handle_error(errorMsg);
+        }
+    }
+    fclose(file);
+}
+
+/**
+ * @brief   Saves the current thread count and synchronization settings in
+ *          the format read by load_config().
+ *
+ * @param   path Configuration file to write.
+ */
+void save_config(const char* path)
+{
+    FILE* file = fopen(path, "w");
+
+    if (!file) {
+        char errorMsg[MAX_STRING * 2];
+        snprintf(errorMsg, sizeof(errorMsg), "Error creating config %s: %s",
+                path, strerror(errno));
+        handle_error(errorMsg);
+    }
+    fprintf(file, "# Written by the a2 autotuner\n"
+            "threads=%d\n"
+            "writer_lock=%s\n"
+            "backoff=%s\n"
+            "affinity=%s\n",
+            options.num_threads,
+            writer_lock_names[options.writer_lock],
+            backoff_names[options.backoff],
+            affinity_names[options.affinity]);
+    if (fclose(file) != 0) {
+        handle_error("Error writing config");
+    }
+}
+
+/**
+ * @brief   Retrieves the program options.
+ *
+ * @return  Pointer to the Options structure.
+ */
+Options* get_options()
+{
+    return &options;
 }
 
 /* end arg_parser.c */
@@ -5,24 +5,89 @@
  * @version 1.0
  *
  * @brief   Declares the parse_args() function for argument parsing.
- * 
- * @details This header provides the declaration for the function responsible 
- *          for parsing command line arguments of the program.
+ *
+ * @details This header provides the Options structure and the declaration
+ *          for the function responsible for parsing command line arguments
+ *          of the program.
  */
 
 #ifndef ARG_PARSER_H
 #define ARG_PARSER_H
 
+#include "queue_lock.h"
+
+/**
+ * @struct  Options
+ *
+ * @brief   Run configuration gathered from the command line.
+ */
+typedef struct {
+    int num_threads;            /* Total threads to create              */
+    int ops_per_thread;         /* Operations each thread performs      */
+    int writer_lock;            /* WRITER_LOCK_* synchronization scheme */
+    BackoffPolicy backoff;      /* Spin policy for the MCS writer lock  */
+    int quiet;                  /* Suppress per-operation output        */
+    int elimination;            /* Cancel out contended writer pairs    */
+    const char* wal_path;       /* Log path prefix, or NULL if volatile */
+    const char* socket_path;    /* Serve on this socket, or NULL        */
+    int perf_counters;          /* Capture hardware counters for a run  */
+    long deadline_us;           /* Per-operation deadline, 0 for none   */
+    int duration_sec;           /* Run for this long instead of -n ops  */
+    long report_ms;             /* Live report interval, 0 for none     */
+    int report_json;            /* Print live reports as JSON lines     */
+    int affinity;               /* AFFINITY_NONE, _COMPACT or _SPREAD   */
+    const char* tune_path;      /* Autotune and save config, or NULL    */
+    long p99_limit_us;          /* Autotune p99 latency limit           */
+    long seed;                  /* Thread mix seed, -1 for the time     */
+    long history_capacity;      /* Sum history entries, 0 for none      */
+    int replicas;               /* Read replica threads, 0 for none     */
+    const char* baseline_path;  /* Regression baseline, or NULL         */
+    int record_baseline;        /* Record the baseline instead of gating */
+    double regress_threshold;   /* Allowed throughput loss, percent     */
+    const char* trace_path;     /* Record lock events here, or NULL     */
+    const char* schedule_scenario; /* Simulated scheduler, or NULL      */
+    const char* replay_path;    /* Replay this lock trace, or NULL      */
+} Options;
+
 /**
  * @brief   Declaration for the function that parses command line arguments.
- * 
+ *
  * @details This function checks the number of arguments and their validity.
  *          If arguments are not valid, it will print an error message.
- * 
+ *
  * @param   argc Count of command line arguments.
  * @param   argv Array of command line arguments.
- * @param   num_threads Pointer to the number of threads to be used.
+ *
+ * @return  Pointer to the parsed options.
+ */
+Options* parse_args(int argc, char* argv[]);
+
+/**
+ * @brief   Loads a configuration file saved by the autotuner.
+ *
+ * @details Each line holds one `key=value` setting; blank lines and lines
+ *          starting with `#` are ignored. Recognised keys are threads,
+ *          writer_lock, backoff and affinity. Exits on an unreadable file
+ *          or invalid setting.
+ *
+ * @param   path Configuration file to load.
+ */
+void load_config(const char* path);
+
+/**
+ * @brief   Saves the current thread count and synchronization settings in
+ *          the format read by load_config().
+ *
+ * @param   path Configuration file to write.
+ */
+void save_config(const char* path);
+
+/**
+ * @brief   Retrieves the program options.
+ *
+ * @return  Pointer to the Options structure, holding defaults until
+ *          parse_args() has been called.
  */
-void parse_args(int argc, char* argv[], int* num_threads);
+Options* get_options();
 
 #endif /* ARG_PARSER_H */
@@ -0,0 +1,181 @@
+/**
+ * @file    autotune.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the throughput autotuner.
+ *
+ * @details Every trial reuses the process's resources and shared data: the
+ *          writer lock is reconfigured between trials while no threads are
+ *          running, and a fresh set of counter slots measures each one.
+ *          Trials use a fixed mix of a quarter incrementers, a quarter
+ *          decrementers and the rest readers, so that they are comparable.
+ *          Affinity layouts are only tried when there is more than one CPU.
+ *          Trial writes are not logged or recorded. Replicas are never
+ *          started in autotune mode.
+ */
+
+#include <unistd.h>
+#include "common.h"
+#include "arg_parser.h"
+#include "resources.h"
+#include "stats.h"
+#include "thread_operations.h"
+#include "autotune.h"
+
+/**
+ * @struct  Backend
+ *
+ * @brief   Writer lock strategy tried by the autotuner.
+ */
+typedef struct {
+    int writer_lock;            /* WRITER_LOCK_* synchronization scheme */
+    BackoffPolicy backoff;      /* Spin policy for the MCS writer lock  */
+    const char* name;           /* Name shown in the trial table        */
+} Backend;
+
+/**
+ * @struct  Trial
+ *
+ * @brief   Configuration and result of one calibration trial.
+ */
+typedef struct {
+    int threads;                /* Total worker threads                 */
+    const Backend* backend;     /* Writer lock strategy                 */
+    int affinity;               /* AFFINITY_* layout                    */
+    double throughput;          /* Completed operations per second      */
+    long p99_ns;                /* p99 operation latency                */
+} Trial;
+
+static const int tune_threads[] = { 3, 4, 6, 8, 12, 16, 24, 32 };
+
+static const Backend tune_backends[] = {
+    { WRITER_LOCK_SEM, BACKOFF_NONE, "sem" },
+    { WRITER_LOCK_MCS, BACKOFF_NONE, "mcs" },
+    { WRITER_LOCK_MCS, BACKOFF_EXPONENTIAL, "mcs/exp" },
+    { WRITER_LOCK_MCS, BACKOFF_PROPORTIONAL, "mcs/prop" },
+    { WRITER_LOCK_DELEGATE, BACKOFF_NONE, "delegate" }
+};
+
+static const char* const affinity_labels[] = { "none", "compact", "spread" };
+
+#define NUM_TUNE_THREADS (int)(sizeof(tune_threads) / sizeof(*tune_threads))
+#define NUM_TUNE_BACKENDS (int)(sizeof(tune_backends) / sizeof(*tune_backends))
+
+/**
+ * @brief   Applies a trial's configuration to the options and resources.
+ *
+ * @param   trial Trial whose configuration to apply.
+ */
+static void apply_trial(const Trial* trial)
+{
+    Options* options = get_options();
+
+    options->num_threads = trial->threads;
+    options->writer_lock = trial->backend->writer_lock;
+    options->backoff = trial->backend->backoff;
+    options->affinity = trial->affinity;
+    configure_writer_lock();
+}
+
+/**
+ * @brief   Runs one timed trial and records its throughput and latency.
+ *
+ * @param   trial Trial to run; receives the results.
+ */
+static void run_trial(Trial* trial)
+{
+    Measurement result;
+    int writers = trial->threads / 4 > 0 ? trial->threads / 4 : 1;
+
+    apply_trial(trial);
+    measure_workers(writers, writers, trial->threads - 2 * writers,
+                    TUNE_TRIAL_MS, &result);
+    trial->throughput = result.throughput;
+    trial->p99_ns = result.tail_ns;
+}
+
+/**
+ * @brief   Prints one row of the trial table.
+ *
+ * @param   trial Completed trial.
+ * @param   limit p99 latency limit in nanoseconds.
+ */
+static void print_trial(const Trial* trial, long limit)
+{
+    printf("%7d  %-8s  %-7s  %12.0f  %10.1f%s\n",
+            trial->threads, trial->backend->name,
+            affinity_labels[trial->affinity], trial->throughput,
+            trial->p99_ns / (double)NSEC_PER_USEC,
+            trial->p99_ns > limit ? "  over limit" : "");
+    fflush(stdout);
+}
+
+/**
+ * @brief   Runs the calibration trials and saves the chosen configuration.
+ *
+ * @details Picks the trial with the highest throughput among those within
+ *          the p99 limit. If none is within it, the trial with the lowest
+ *          p99 is chosen instead.
+ *
+ * @param   config_path File to save the configuration to.
+ */
+void run_autotune(const char* config_path)
+{
+    Options* options = get_options();
+    long limit = options->p99_limit_us * NSEC_PER_USEC;
+    int num_layouts = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 3 : 1;
+    Trial best = { 0 };
+    Trial lowest_p99 = { 0 };
+    int found = 0;
+
+    /* Trials reuse the thread array at its largest size */
+    begin_calibration(tune_threads[NUM_TUNE_THREADS - 1]);
+
+    printf("Autotuning with %d ms trials, p%g limit %ld us\n",
+            TUNE_TRIAL_MS, TAIL_PERCENTILE, options->p99_limit_us);
+    printf("threads  backend   layout        ops/s    p99 (us)\n");
+
+    for (int t = 0; t < NUM_TUNE_THREADS; t++) {
+        for (int b = 0; b < NUM_TUNE_BACKENDS; b++) {
+            for (int a = 0; a < num_layouts; a++) {
+                Trial trial = {
+                    .threads = tune_threads[t],
+                    .backend = &tune_backends[b],
+                    .affinity = a
+                };
+                run_trial(&trial);
+                print_trial(&trial, limit);
+
+                if (trial.p99_ns <= limit &&
+                    (!found || trial.throughput > best.throughput)) {
+                    best = trial;
+                    found = 1;
+                }
+                if (!lowest_p99.backend || trial.p99_ns < lowest_p99.p99_ns) {
+                    lowest_p99 = trial;
+                }
+            }
+        }
+    }
+
+    end_calibration();
+
+    if (!found) {
+        printf("No configuration met the limit; using the lowest p%g.\n",
+                TAIL_PERCENTILE);
+        best = lowest_p99;
+    }
+    apply_trial(&best);
+    save_config(config_path);
+
+    printf("Chose %d threads, %s writer lock, %s affinity: "
+            "%.0f ops/s, p%g %.1f us\n",
+            best.threads, best.backend->name, affinity_labels[best.affinity],
+            best.throughput, TAIL_PERCENTILE,
+            best.p99_ns / (double)NSEC_PER_USEC);
+    printf("Saved to %s; load it with -C %s\n", config_path, config_path);
+}
+
+/* end autotune.c */
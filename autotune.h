@@ -0,0 +1,27 @@
+/**
+ * @file    autotune.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the throughput autotuner.
+ *
+ * @details The autotuner runs short timed trials over thread counts,
+ *          affinity layouts and writer lock backends, then saves the
+ *          configuration with the highest throughput whose p99 operation
+ *          latency stays within the configured limit.
+ */
+
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#define TUNE_TRIAL_MS 200           /* Length of each calibration trial   */
+
+/**
+ * @brief   Runs the calibration trials and saves the chosen configuration.
+ *
+ * @param   config_path File to save the configuration to.
+ */
+void run_autotune(const char* config_path);
+
+#endif /* AUTOTUNE_H */
@@ -0,0 +1,285 @@
+/**
+ * @file    client.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Load-generating client for the counter server.
+ *
+ * @details Opens a number of connections to a server started with
+ *          `a2 -S socket`, one thread per connection. Each connection keeps
+ *          up to a fixed number of requests in flight, writing each refill
+ *          as a single batch, and records the latency of every request.
+ *          Throughput and latency percentiles are printed at the end.
+ *
+ *          Compile with `make a2_client` and run with
+ *          `./a2_client [-c connections] [-d depth] [-n requests]
+ *          [-r read_percent] socket`.
+ */
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "common.h"
+#include "protocol.h"
+
+#define DEFAULT_CONNECTIONS 4
+#define DEFAULT_DEPTH 32
+#define DEFAULT_REQUESTS 100000
+#define DEFAULT_READ_PERCENT 50
+#define MAX_DEPTH 4096
+#define USAGE "Usage: %s [-c connections] [-d depth] [-n requests] " \
+              "[-r read_percent] socket\n"
+
+/**
+ * @struct  ClientThread
+ *
+ * @brief   Work and results of one connection.
+ */
+typedef struct {
+    pthread_t thread;
+    const char* socket_path;    /* Server socket                         */
+    int depth;                  /* Requests kept in flight               */
+    long requests;              /* Requests to send                      */
+    int read_percent;           /* Share of requests that are reads      */
+    unsigned int seed;          /* Per-connection operation mix seed     */
+    long* latencies;            /* Latency of each request, nanoseconds  */
+} ClientThread;
+
+/**
+ * @brief   Prints an error message and exits.
+ *
+ * @param   msg Description of the error.
+ */
+static void client_error(const char* msg)
+{
+    fprintf(stderr, "%s: %s\n", msg, strerror(errno));
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief   Reads the monotonic clock.
+ *
+ * @return  Current time in nanoseconds.
+ */
+static long now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief   Connects to the server.
+ *
+ * @param   socket_path Server socket.
+ *
+ * @return  The connected socket.
+ */
+static int connect_server(const char* socket_path)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        client_error("Error creating socket");
+    }
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        client_error("Error connecting to server");
+    }
+    return fd;
+}
+
+/**
+ * @brief   Writes a whole buffer to a blocking socket.
+ *
+ * @param   fd  Socket to write to.
+ * @param   buf Data to write.
+ * @param   len Length of the data.
+ */
+static void write_all(int fd, const void* buf, size_t len)
+{
+    const char* p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            client_error("Error sending requests");
+        }
+        p += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief   Sends requests over one connection, keeping the pipeline full.
+ *
+ * @param   arg Pointer to the connection's ClientThread.
+ *
+ * @return  NULL
+ */
+static void* run_connection(void* arg)
+{
+    ClientThread* ct = arg;
+    Request batch[MAX_DEPTH];
+    Response responses[MAX_DEPTH];
+    long sent_at[MAX_DEPTH];
+    size_t partial = 0;         /* Bytes of a response split across reads */
+    long sent = 0, received = 0;
+    int fd = connect_server(ct->socket_path);
+
+    while (received < ct->requests) {
+        /* Top the pipeline up with one batched write */
+        int count = 0;
+        while (sent - received < ct->depth && sent < ct->requests) {
+            Request* req = &batch[count++];
+            int roll = rand_r(&ct->seed) % 100;
+            req->tag = (uint32_t)sent;
+            req->op = roll < ct->read_percent ? PROTO_READ
+                    : (roll & 1) ? PROTO_INCR : PROTO_DECR;
+            req->reserved = 0;
+            sent_at[sent % ct->depth] = now_ns();
+            sent++;
+        }
+        write_all(fd, batch, count * sizeof(Request));
+
+        /* Collect whatever responses have arrived */
+        ssize_t n = read(fd, (char*)responses + partial,
+                         sizeof(responses) - partial);
+        if (n <= 0) {
+            client_error("Error receiving responses");
+        }
+        long now = now_ns();
+        size_t bytes = partial + n;
+        size_t whole = bytes / sizeof(Response);
+        for (size_t i = 0; i < whole; i++) {
+            uint32_t tag = responses[i].tag;
+            ct->latencies[tag] = now - sent_at[tag % ct->depth];
+            received++;
+        }
+        partial = bytes % sizeof(Response);
+        memmove(responses, (char*)responses + whole * sizeof(Response),
+                partial);
+    }
+
+    close(fd);
+    return NULL;
+}
+
+/**
+ * @brief   Orders latencies for qsort().
+ *
+ * @param   a First latency.
+ * @param   b Second latency.
+ *
+ * @return  Negative, zero or positive as a is less, equal or greater.
+ */
+static int compare_latency(const void* a, const void* b)
+{
+    long x = *(const long*)a, y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief   Prints throughput and latency percentiles.
+ *
+ * @param   latencies Latency of every request, sorted ascending.
+ * @param   total     Number of requests.
+ * @param   elapsed   Wall-clock duration of the run in nanoseconds.
+ */
+static void print_report(const long* latencies, long total, long elapsed)
+{
+    const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+    printf("%ld requests in %.3f s: %.0f requests/s\n", total,
+            (double)elapsed / NSEC_PER_SEC,
+            total * (double)NSEC_PER_SEC / elapsed);
+    printf("latency (us):");
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(*percentiles); i++) {
+        long index = (long)(percentiles[i] / 100.0 * (total - 1));
+        printf(" p%g %.1f", percentiles[i],
+                latencies[index] / (double)NSEC_PER_USEC);
+    }
+    printf(" max %.1f\n", latencies[total - 1] / (double)NSEC_PER_USEC);
+}
+
+/**
+ * @brief   Client entry point.
+ *
+ * @param   argc Number of command line arguments.
+ * @param   argv Array of command line arguments.
+ *
+ * @return  Exits with `EXIT_SUCCESS` on success.
+ */
+int main(int argc, char* argv[])
+{
+    int connections = DEFAULT_CONNECTIONS;
+    int depth = DEFAULT_DEPTH;
+    long requests = DEFAULT_REQUESTS;
+    int read_percent = DEFAULT_READ_PERCENT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:d:n:r:")) != -1) {
+        switch (opt) {
+        case 'c':
+            connections = atoi(optarg);
+            break;
+        case 'd':
+            depth = atoi(optarg);
+            break;
+        case 'n':
+            requests = atol(optarg);
+            break;
+        case 'r':
+            read_percent = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, USAGE, argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (optind != argc - 1 || connections < 1 || depth < 1 ||
+        depth > MAX_DEPTH || requests < connections ||
+        read_percent < 0 || read_percent > 100) {
+        fprintf(stderr, USAGE, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    ClientThread* threads = calloc(connections, sizeof(ClientThread));
+    long* latencies = malloc(requests * sizeof(long));
+    if (!threads || !latencies) {
+        client_error("Error allocating memory for client threads");
+    }
+
+    /* Split the requests evenly and start one thread per connection */
+    long start = now_ns();
+    long offset = 0;
+    for (int i = 0; i < connections; i++) {
+        ClientThread* ct = &threads[i];
+        ct->socket_path = argv[optind];
+        ct->depth = depth;
+        ct->requests = requests / connections +
+                       (i < requests % connections ? 1 : 0);
+        ct->read_percent = read_percent;
+        ct->seed = (unsigned int)i + 1;
+        ct->latencies = latencies + offset;
+        offset += ct->requests;
+        if (pthread_create(&ct->thread, NULL, run_connection, ct) != 0) {
+            client_error("Error creating client thread");
+        }
+    }
+    for (int i = 0; i < connections; i++) {
+        pthread_join(threads[i].thread, NULL);
+    }
+    long elapsed = now_ns() - start;
+
+    qsort(latencies, requests, sizeof(long), compare_latency);
+    print_report(latencies, requests, elapsed);
+
+    free(latencies);
+    free(threads);
+    exit(EXIT_SUCCESS);
+}
+
+/* end client.c */
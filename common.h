@@ -27,5 +27,21 @@
 #define READ_OP 0
 #define INCR_OP 1
 #define DECR_OP -1
+#define DEFAULT_OPS 1
+#define CACHE_LINE_SIZE 64
+#define WRITER_LOCK_SEM 0
+#define WRITER_LOCK_MCS 1
+#define WRITER_LOCK_DELEGATE 2
+#define AFFINITY_NONE 0
+#define AFFINITY_COMPACT 1
+#define AFFINITY_SPREAD 2
+#define DEFAULT_P99_LIMIT_US 10000
+#define DEFAULT_REGRESS_THRESHOLD 10.0
+#define OP_INDEX(op) ((op) == READ_OP ? 0 : (op) == INCR_OP ? 1 : 2)
+#define OP_OK 0
+#define OP_TIMEOUT 1
+#define NSEC_PER_USEC 1000L
+#define NSEC_PER_SEC 1000000000L
+#define USEC_PER_SEC 1000000L
 
 #endif /* COMMON_H */
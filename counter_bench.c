@@ -0,0 +1,228 @@
+/**
+ * @file    counter_bench.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Microbenchmark for the counter array kernels.
+ *
+ * @details Times the sum, min/max and copy kernels of every instruction set
+ *          the CPU supports against the scalar loop over one large array,
+ *          checks that all versions agree, then times a consistent snapshot
+ *          taken while another thread keeps updating the array.
+ *
+ *          Compile with `make counter_bench` and run with
+ *          `./counter_bench [counters] [repetitions]`.
+ */
+
+#include "common.h"
+#include "counters.h"
+
+#define DEFAULT_BENCH_COUNTERS (1L << 20)
+#define DEFAULT_BENCH_REPS 50
+#define USAGE "Usage: %s [counters] [repetitions]\n"
+
+static long* values;
+static long* copy;
+static size_t count;
+static atomic_ulong seq = 0;
+static atomic_int writing = 0;
+
+/**
+ * @brief   Reads the monotonic clock.
+ *
+ * @return  Current time in nanoseconds.
+ */
+static long now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief   Prints one timing row.
+ *
+ * @param   isa     Instruction set name.
+ * @param   kernel  Kernel name.
+ * @param   elapsed Time for all repetitions in nanoseconds.
+ * @param   reps    Number of repetitions.
+ * @param   scalar  Time the scalar kernel took, or 0 for the scalar row.
+ */
+static void print_row(const char* isa, const char* kernel, long elapsed,
+                      int reps, long scalar)
+{
+    double per_counter = (double)elapsed / reps / count;
+    printf("%-8s %-7s %8.3f ns/counter %8.2f GB/s", isa, kernel, per_counter,
+            sizeof(long) / per_counter);
+    if (scalar) {
+        printf("  %5.2fx scalar", (double)scalar / elapsed);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief   Times one instruction set's kernels and checks their results.
+ *
+ * @param   kernels Kernels to time.
+ * @param   reps    Number of repetitions.
+ * @param   scalar  Scalar timings of sum, min/max and copy, filled in when
+ *                  timing the scalar kernels themselves.
+ */
+static void bench_kernels(const CounterKernels* kernels, int reps,
+                          long scalar[3])
+{
+    static long expected_sum, expected_min, expected_max;
+    int is_scalar = scalar[0] == 0;
+    long sum = 0, min = 0, max = 0, start;
+    long elapsed[3];
+
+    start = now_ns();
+    for (int r = 0; r < reps; r++) {
+        sum = kernels->sum(values, count);
+    }
+    elapsed[0] = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < reps; r++) {
+        kernels->minmax(values, count, &min, &max);
+    }
+    elapsed[1] = now_ns() - start;
+
+    memset(copy, 0, count * sizeof(long));
+    start = now_ns();
+    for (int r = 0; r < reps; r++) {
+        kernels->copy(copy, values, count);
+    }
+    elapsed[2] = now_ns() - start;
+
+    if (is_scalar) {
+        expected_sum = sum;
+        expected_min = min;
+        expected_max = max;
+        memcpy(scalar, elapsed, sizeof(elapsed));
+    } else if (sum != expected_sum || min != expected_min ||
+               max != expected_max ||
+               memcmp(copy, values, count * sizeof(long)) != 0) {
+        fprintf(stderr, "%s kernels disagree with the scalar loop\n",
+                kernels->name);
+        exit(EXIT_FAILURE);
+    }
+
+    print_row(kernels->name, "sum", elapsed[0], reps,
+              is_scalar ? 0 : scalar[0]);
+    print_row(kernels->name, "minmax", elapsed[1], reps,
+              is_scalar ? 0 : scalar[1]);
+    print_row(kernels->name, "copy", elapsed[2], reps,
+              is_scalar ? 0 : scalar[2]);
+}
+
+/**
+ * @brief   Keeps updating the array under its sequence counter.
+ *
+ * @param   arg Unused.
+ *
+ * @return  NULL
+ */
+static void* writer(void* arg)
+{
+    unsigned int rng = 1;
+
+    (void)arg;
+    while (atomic_load_explicit(&writing, memory_order_relaxed)) {
+        size_t i = rand_r(&rng) % (count - 1);
+        counters_write_begin(&seq);
+        values[i]++;
+        values[i + 1]--;
+        counters_write_end(&seq);
+    }
+    return NULL;
+}
+
+/**
+ * @brief   Times snapshots taken while a writer updates the array, checking
+ *          that every snapshot preserves the array's total.
+ *
+ * @param   reps Number of snapshots.
+ */
+static void bench_snapshot(int reps)
+{
+    long total = counters_sum(values, count);
+    long retries = 0;
+    pthread_t thread;
+
+    atomic_store(&writing, 1);
+    if (pthread_create(&thread, NULL, writer, NULL) != 0) {
+        perror("Error creating writer thread");
+        exit(EXIT_FAILURE);
+    }
+
+    long start = now_ns();
+    for (int r = 0; r < reps; r++) {
+        retries += counters_snapshot(copy, values, count, &seq);
+        if (counters_sum(copy, count) != total) {
+            fprintf(stderr, "Snapshot was not consistent\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    long elapsed = now_ns() - start;
+
+    atomic_store(&writing, 0);
+    pthread_join(thread, NULL);
+    print_row(counter_kernels()->name, "snapshot", elapsed, reps, 0);
+    printf("%ld snapshots discarded for overlapping an update\n", retries);
+}
+
+/**
+ * @brief   Benchmark entry point.
+ *
+ * @param   argc Number of command line arguments.
+ * @param   argv Array of command line arguments.
+ *
+ * @return  Exits with `EXIT_SUCCESS` on success.
+ */
+int main(int argc, char* argv[])
+{
+    int reps = DEFAULT_BENCH_REPS;
+    long scalar[3] = { 0, 0, 0 };
+    unsigned int rng = 42;
+
+    count = DEFAULT_BENCH_COUNTERS;
+    if (argc > 3 || (argc > 1 && atol(argv[1]) < 2) ||
+        (argc > 2 && atoi(argv[2]) < 1)) {
+        fprintf(stderr, USAGE, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (argc > 1) {
+        count = atol(argv[1]);
+    }
+    if (argc > 2) {
+        reps = atoi(argv[2]);
+    }
+
+    values = malloc(count * sizeof(long));
+    copy = malloc(count * sizeof(long));
+    if (!values || !copy) {
+        perror("Error allocating counters");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (long)(rand_r(&rng) % 2000001) - 1000000;
+    }
+
+    printf("%zu counters, %d repetitions, selected %s\n",
+            count, reps, counter_kernels()->name);
+    for (int isa = 0; isa < NUM_COUNTER_ISAS; isa++) {
+        const CounterKernels* kernels = counter_kernels_for(isa);
+        if (kernels) {
+            bench_kernels(kernels, reps, scalar);
+        }
+    }
+    bench_snapshot(reps);
+
+    free(values);
+    free(copy);
+    exit(EXIT_SUCCESS);
+}
+
+/* end counter_bench.c */
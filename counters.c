@@ -0,0 +1,394 @@
+/**
+ * @file    counters.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements vectorized kernels over arrays of counters.
+ *
+ * @details The vector versions are compiled with per-function target
+ *          attributes, so the rest of the program needs no special flags.
+ *          Each keeps two independent accumulators to hide instruction
+ *          latency, then finishes the remainder with the scalar loop.
+ *          Vector min/max needs 64-bit compares, which arrived with SSE4.2.
+ *          On other architectures only the scalar kernels exist.
+ */
+
+#include <pthread.h>
+#include "common.h"
+#include "queue_lock.h"
+#include "counters.h"
+
+/* The vector kernels treat each long as a 64-bit lane */
+#if defined(__x86_64__)
+#define COUNTERS_X86
+#include <immintrin.h>
+#endif
+
+/* The scalar kernels are the reference the vector ones are timed against,
+ * so keep the compiler from vectorizing them or turning the copy into a
+ * memcpy() call */
+#define SCALAR_KERNEL \
+    __attribute__((optimize("no-tree-vectorize", \
+                            "no-tree-loop-distribute-patterns")))
+
+static const CounterKernels* selected = NULL;
+static pthread_once_t select_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief   Sums counters one at a time.
+ *
+ * @param   values Counters to sum.
+ * @param   count  Number of counters.
+ *
+ * @return  The total.
+ */
+SCALAR_KERNEL static long scalar_sum(const long* values, size_t count)
+{
+    long total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += values[i];
+    }
+    return total;
+}
+
+/**
+ * @brief   Finds the smallest and largest counters one at a time.
+ *
+ * @param   values Counters to scan.
+ * @param   count  Number of counters, at least 1.
+ * @param   min    Receives the smallest counter.
+ * @param   max    Receives the largest counter.
+ */
+SCALAR_KERNEL static void scalar_minmax(const long* values, size_t count,
+                                        long* min, long* max)
+{
+    long lo = values[0], hi = values[0];
+    for (size_t i = 1; i < count; i++) {
+        if (values[i] < lo) {
+            lo = values[i];
+        }
+        if (values[i] > hi) {
+            hi = values[i];
+        }
+    }
+    *min = lo;
+    *max = hi;
+}
+
+/**
+ * @brief   Copies counters one at a time.
+ *
+ * @param   dst   Destination array.
+ * @param   src   Source array.
+ * @param   count Number of counters.
+ */
+SCALAR_KERNEL static void scalar_copy(long* dst, const long* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = src[i];
+    }
+}
+
+#ifdef COUNTERS_X86
+
+/**
+ * @brief   Sums counters two 128-bit lanes at a time.
+ *
+ * @param   values Counters to sum.
+ * @param   count  Number of counters.
+ *
+ * @return  The total.
+ */
+__attribute__((target("sse4.2")))
+static long sse_sum(const long* values, size_t count)
+{
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    long lanes[2];
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_epi64(acc0,
+                _mm_loadu_si128((const __m128i*)(values + i)));
+        acc1 = _mm_add_epi64(acc1,
+                _mm_loadu_si128((const __m128i*)(values + i + 2)));
+    }
+    _mm_storeu_si128((__m128i*)lanes, _mm_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + scalar_sum(values + i, count - i);
+}
+
+/**
+ * @brief   Finds the smallest and largest counters two at a time.
+ *
+ * @param   values Counters to scan.
+ * @param   count  Number of counters, at least 1.
+ * @param   min    Receives the smallest counter.
+ * @param   max    Receives the largest counter.
+ */
+__attribute__((target("sse4.2")))
+static void sse_minmax(const long* values, size_t count, long* min, long* max)
+{
+    __m128i lo = _mm_set1_epi64x(values[0]), hi = lo;
+    long lo_lanes[2], hi_lanes[2];
+    size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        lo = _mm_blendv_epi8(lo, v, _mm_cmpgt_epi64(lo, v));
+        hi = _mm_blendv_epi8(hi, v, _mm_cmpgt_epi64(v, hi));
+    }
+    _mm_storeu_si128((__m128i*)lo_lanes, lo);
+    _mm_storeu_si128((__m128i*)hi_lanes, hi);
+    scalar_minmax(values + (i ? i - 1 : 0), count - (i ? i - 1 : 0), min, max);
+    for (int lane = 0; lane < 2; lane++) {
+        if (lo_lanes[lane] < *min) {
+            *min = lo_lanes[lane];
+        }
+        if (hi_lanes[lane] > *max) {
+            *max = hi_lanes[lane];
+        }
+    }
+}
+
+/**
+ * @brief   Copies counters four at a time.
+ *
+ * @param   dst   Destination array.
+ * @param   src   Source array.
+ * @param   count Number of counters.
+ */
+__attribute__((target("sse4.2")))
+static void sse_copy(long* dst, const long* src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 2));
+        _mm_storeu_si128((__m128i*)(dst + i), a);
+        _mm_storeu_si128((__m128i*)(dst + i + 2), b);
+    }
+    scalar_copy(dst + i, src + i, count - i);
+}
+
+/**
+ * @brief   Sums counters two 256-bit lanes at a time.
+ *
+ * @param   values Counters to sum.
+ * @param   count  Number of counters.
+ *
+ * @return  The total.
+ */
+__attribute__((target("avx2")))
+static long avx2_sum(const long* values, size_t count)
+{
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    long lanes[4];
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_epi64(acc0,
+                _mm256_loadu_si256((const __m256i*)(values + i)));
+        acc1 = _mm256_add_epi64(acc1,
+                _mm256_loadu_si256((const __m256i*)(values + i + 4)));
+    }
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           scalar_sum(values + i, count - i);
+}
+
+/**
+ * @brief   Finds the smallest and largest counters four at a time.
+ *
+ * @param   values Counters to scan.
+ * @param   count  Number of counters, at least 1.
+ * @param   min    Receives the smallest counter.
+ * @param   max    Receives the largest counter.
+ */
+__attribute__((target("avx2")))
+static void avx2_minmax(const long* values, size_t count, long* min, long* max)
+{
+    __m256i lo = _mm256_set1_epi64x(values[0]), hi = lo;
+    long lo_lanes[4], hi_lanes[4];
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        lo = _mm256_blendv_epi8(lo, v, _mm256_cmpgt_epi64(lo, v));
+        hi = _mm256_blendv_epi8(hi, v, _mm256_cmpgt_epi64(v, hi));
+    }
+    _mm256_storeu_si256((__m256i*)lo_lanes, lo);
+    _mm256_storeu_si256((__m256i*)hi_lanes, hi);
+    scalar_minmax(values + (i ? i - 1 : 0), count - (i ? i - 1 : 0), min, max);
+    for (int lane = 0; lane < 4; lane++) {
+        if (lo_lanes[lane] < *min) {
+            *min = lo_lanes[lane];
+        }
+        if (hi_lanes[lane] > *max) {
+            *max = hi_lanes[lane];
+        }
+    }
+}
+
+/**
+ * @brief   Copies counters eight at a time.
+ *
+ * @param   dst   Destination array.
+ * @param   src   Source array.
+ * @param   count Number of counters.
+ */
+__attribute__((target("avx2")))
+static void avx2_copy(long* dst, const long* src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i + 4));
+        _mm256_storeu_si256((__m256i*)(dst + i), a);
+        _mm256_storeu_si256((__m256i*)(dst + i + 4), b);
+    }
+    scalar_copy(dst + i, src + i, count - i);
+}
+
+#endif /* COUNTERS_X86 */
+
+static const CounterKernels kernel_table[NUM_COUNTER_ISAS] = {
+    { "scalar", scalar_sum, scalar_minmax, scalar_copy },
+#ifdef COUNTERS_X86
+    { "sse4.2", sse_sum, sse_minmax, sse_copy },
+    { "avx2", avx2_sum, avx2_minmax, avx2_copy }
+#endif
+};
+
+/**
+ * @brief   Retrieves the kernels for a specific instruction set.
+ *
+ * @param   isa COUNTER_ISA_SCALAR, COUNTER_ISA_SSE or COUNTER_ISA_AVX2.
+ *
+ * @return  Pointer to the kernels, or NULL if the CPU does not support them.
+ */
+const CounterKernels* counter_kernels_for(int isa)
+{
+    switch (isa) {
+    case COUNTER_ISA_SCALAR:
+        return &kernel_table[COUNTER_ISA_SCALAR];
+#ifdef COUNTERS_X86
+    case COUNTER_ISA_SSE:
+        return __builtin_cpu_supports("sse4.2") ?
+               &kernel_table[COUNTER_ISA_SSE] : NULL;
+    case COUNTER_ISA_AVX2:
+        return __builtin_cpu_supports("avx2") ?
+               &kernel_table[COUNTER_ISA_AVX2] : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief   Picks the widest supported kernels.
+ */
+static void select_kernels()
+{
+    for (int isa = NUM_COUNTER_ISAS - 1; isa >= 0 && !selected; isa--) {
+        selected = counter_kernels_for(isa);
+    }
+}
+
+/**
+ * @brief   Retrieves the fastest kernels the CPU supports.
+ *
+ * @return  Pointer to the selected kernels.
+ */
+const CounterKernels* counter_kernels()
+{
+    pthread_once(&select_once, select_kernels);
+    return selected;
+}
+
+/**
+ * @brief   Sums an array of counters.
+ *
+ * @param   values Counters to sum.
+ * @param   count  Number of counters.
+ *
+ * @return  The total.
+ */
+long counters_sum(const long* values, size_t count)
+{
+    return counter_kernels()->sum(values, count);
+}
+
+/**
+ * @brief   Finds the smallest and largest of a non-empty array of counters.
+ *
+ * @param   values Counters to scan.
+ * @param   count  Number of counters, at least 1.
+ * @param   min    Receives the smallest counter.
+ * @param   max    Receives the largest counter.
+ */
+void counters_minmax(const long* values, size_t count, long* min, long* max)
+{
+    counter_kernels()->minmax(values, count, min, max);
+}
+
+/**
+ * @brief   Copies a counter array that writers update under a sequence
+ *          counter, retrying until the copy is consistent.
+ *
+ * @details The copy itself is a plain memcpy(), which beats the vector copy
+ *          kernels; a copy that overlapped an update is detected by the
+ *          sequence changing and discarded.
+ *
+ * @param   dst   Receives the snapshot.
+ * @param   src   Counters to copy.
+ * @param   count Number of counters.
+ * @param   seq   Sequence counter guarding the array.
+ *
+ * @return  Number of attempts that were discarded.
+ */
+int counters_snapshot(long* dst, const long* src, size_t count,
+                      atomic_ulong* seq)
+{
+    int retries = 0;
+
+    for (;;) {
+        unsigned long before = atomic_load_explicit(seq, memory_order_acquire);
+        if (before & 1) {
+            cpu_relax();
+            continue;
+        }
+        memcpy(dst, src, count * sizeof(long));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(seq, memory_order_relaxed) == before) {
+            return retries;
+        }
+        retries++;
+    }
+}
+
+/**
+ * @brief   Marks the start of an update to a snapshotted counter array.
+ *
+ * @param   seq Sequence counter guarding the array.
+ */
+void counters_write_begin(atomic_ulong* seq)
+{
+    atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed)
+                          + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * @brief   Marks the end of an update to a snapshotted counter array.
+ *
+ * @param   seq Sequence counter guarding the array.
+ */
+void counters_write_end(atomic_ulong* seq)
+{
+    atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed)
+                          + 1, memory_order_release);
+}
+
+/* end counters.c */
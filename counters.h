@@ -0,0 +1,108 @@
+/**
+ * @file    counters.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares vectorized kernels over arrays of counters.
+ *
+ * @details Summing, min/max and bulk copying of large counter arrays come in
+ *          AVX2, SSE4.2 and scalar versions. The best version the CPU
+ *          supports is chosen at runtime the first time a kernel is used,
+ *          so the program runs unchanged on machines without AVX2.
+ */
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define COUNTER_ISA_SCALAR 0
+#define COUNTER_ISA_SSE 1
+#define COUNTER_ISA_AVX2 2
+#define NUM_COUNTER_ISAS 3
+
+/**
+ * @struct  CounterKernels
+ *
+ * @brief   One instruction set's versions of the counter kernels.
+ */
+typedef struct {
+    const char* name;           /* Instruction set name                 */
+    long (*sum)(const long* values, size_t count);
+    void (*minmax)(const long* values, size_t count, long* min, long* max);
+    void (*copy)(long* dst, const long* src, size_t count);
+} CounterKernels;
+
+/**
+ * @brief   Retrieves the fastest kernels the CPU supports.
+ *
+ * @return  Pointer to the selected kernels.
+ */
+const CounterKernels* counter_kernels();
+
+/**
+ * @brief   Retrieves the kernels for a specific instruction set.
+ *
+ * @param   isa COUNTER_ISA_SCALAR, COUNTER_ISA_SSE or COUNTER_ISA_AVX2.
+ *
+ * @return  Pointer to the kernels, or NULL if the CPU does not support them.
+ */
+const CounterKernels* counter_kernels_for(int isa);
+
+/**
+ * @brief   Sums an array of counters.
+ *
+ * @param   values Counters to sum.
+ * @param   count  Number of counters.
+ *
+ * @return  The total.
+ */
+long counters_sum(const long* values, size_t count);
+
+/**
+ * @brief   Finds the smallest and largest of a non-empty array of counters.
+ *
+ * @param   values Counters to scan.
+ * @param   count  Number of counters, at least 1.
+ * @param   min    Receives the smallest counter.
+ * @param   max    Receives the largest counter.
+ */
+void counters_minmax(const long* values, size_t count, long* min, long* max);
+
+/**
+ * @brief   Copies a counter array that writers update under a sequence
+ *          counter, retrying until the copy is consistent.
+ *
+ * @details Writers make the sequence odd before changing the array and
+ *          even again afterwards, as with counters_write_begin() and
+ *          counters_write_end().
+ *
+ * @param   dst   Receives the snapshot.
+ * @param   src   Counters to copy.
+ * @param   count Number of counters.
+ * @param   seq   Sequence counter guarding the array.
+ *
+ * @return  Number of attempts that were discarded.
+ */
+int counters_snapshot(long* dst, const long* src, size_t count,
+                      atomic_ulong* seq);
+
+/**
+ * @brief   Marks the start of an update to a snapshotted counter array.
+ *
+ * @details Updates must come from one writer at a time.
+ *
+ * @param   seq Sequence counter guarding the array.
+ */
+void counters_write_begin(atomic_ulong* seq);
+
+/**
+ * @brief   Marks the end of an update to a snapshotted counter array.
+ *
+ * @param   seq Sequence counter guarding the array.
+ */
+void counters_write_end(atomic_ulong* seq);
+
+#endif /* COUNTERS_H */
@@ -0,0 +1,238 @@
+/**
+ * @file    delegation.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements delegation of shared data operations to an owner thread.
+ *
+ * @details Each client claims its own cache-line-sized request slot, so
+ *          clients never contend with each other and the owner is the only
+ *          other thread to touch a slot. A slot moves from EMPTY to PENDING
+ *          when the client posts a request, to CLAIMED when the owner takes
+ *          it, and to DONE once the result is written; the client then sets
+ *          it back to EMPTY. A client withdraws a timed-out request by
+ *          moving it from PENDING back to EMPTY, which fails if the owner
+ *          has already claimed it.
+ */
+
+#define _GNU_SOURCE             /* pthread_setaffinity_np() */
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "common.h"
+#include "utilities.h"
+#include "shared_data.h"
+#include "queue_lock.h"
+#include "delegation.h"
+
+#define SLOT_EMPTY 0
+#define SLOT_PENDING 1
+#define SLOT_CLAIMED 2
+#define SLOT_DONE 3
+
+/**
+ * @struct  RequestSlot
+ *
+ * @brief   One client's request and its result.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_int state;
+    int op;                     /* Operation requested                  */
+    int id;                     /* ID of the requesting thread          */
+    int result;                 /* Sum after the operation              */
+} RequestSlot;
+
+static RequestSlot* slots = NULL;
+static int num_slots = 0;
+static atomic_int next_slot = 0;
+static atomic_int owner_running = 0;
+static int generation = 0;
+static int spin_limit = QUEUE_SPIN_LIMIT;
+static pthread_t owner_thread;
+static _Thread_local RequestSlot* my_slot = NULL;
+static _Thread_local int my_generation = 0;
+
+/**
+ * @brief   Performs one claimed request on the shared data.
+ *
+ * @param   slot Slot holding the request.
+ */
+static void serve_request(RequestSlot* slot)
+{
+    SharedData* data = get_shared_data();
+
+    if (slot->op != READ_OP) {
+        modify_shared_data(slot->op, slot->id);
+    }
+    slot->result = data->sum;
+    atomic_store_explicit(&slot->state, SLOT_DONE, memory_order_release);
+}
+
+/**
+ * @brief   Owner thread body: serves request slots until stopped.
+ *
+ * @param   arg Unused.
+ *
+ * @return  NULL
+ */
+static void* owner(void* arg)
+{
+    int idle = 0;
+
+    (void)arg;
+    while (atomic_load_explicit(&owner_running, memory_order_relaxed)) {
+        int served = 0;
+        for (int i = 0; i < num_slots; i++) {
+            int expected = SLOT_PENDING;
+            if (atomic_load_explicit(&slots[i].state,
+                                     memory_order_relaxed) == SLOT_PENDING &&
+                atomic_compare_exchange_strong_explicit(&slots[i].state,
+                        &expected, SLOT_CLAIMED, memory_order_acquire,
+                        memory_order_relaxed)) {
+                serve_request(&slots[i]);
+                served++;
+            }
+        }
+
+        /* Let clients run when there is nothing to do */
+        if (served) {
+            idle = 0;
+        } else if (++idle >= spin_limit) {
+            sched_yield();
+            idle = 0;
+        } else {
+            cpu_relax();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief   Starts the owner thread.
+ *
+ * @param   max_clients Number of threads that may delegate operations.
+ */
+void start_delegation(int max_clients)
+{
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    sigset_t mask, saved;
+
+    slots = aligned_alloc(CACHE_LINE_SIZE, max_clients * sizeof(RequestSlot));
+    if (!slots) {
+        handle_error("Error allocating memory for delegation slots");
+    }
+    for (int i = 0; i < max_clients; i++) {
+        atomic_init(&slots[i].state, SLOT_EMPTY);
+    }
+    num_slots = max_clients;
+    atomic_store(&next_slot, 0);
+
+    /* With one CPU, spinning only delays the thread being waited for */
+    spin_limit = num_cpus > 1 ? QUEUE_SPIN_LIMIT : 1;
+    generation++;
+
+    /* Leave shutdown signals to the other threads; in server mode they
+     * are only read from a signalfd, which needs them blocked everywhere */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &saved);
+    atomic_store(&owner_running, 1);
+    int err = pthread_create(&owner_thread, NULL, owner, NULL);
+    pthread_sigmask(SIG_SETMASK, &saved, NULL);
+    if (err) {
+        handle_error("Error creating owner thread");
+    }
+
+    /* Keep the owner, and so the shared data, on one CPU. The CPU may be
+     * outside the allowed set, so run unpinned rather than fail. */
+    if (num_cpus > 1) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(num_cpus - 1, &cpus);
+        err = pthread_setaffinity_np(owner_thread, sizeof(cpus), &cpus);
+        if (err) {
+            fprintf(stderr, "Warning: could not pin the delegation owner "
+                    "to CPU %ld: %s\n", num_cpus - 1, strerror(err));
+        }
+    }
+}
+
+/**
+ * @brief   Stops the owner thread once every client has finished.
+ */
+void stop_delegation()
+{
+    if (!atomic_exchange(&owner_running, 0)) {
+        return;
+    }
+    pthread_join(owner_thread, NULL);
+    free(slots);
+    slots = NULL;
+    num_slots = 0;
+}
+
+/**
+ * @brief   Finds the calling thread's request slot, claiming one if needed.
+ *
+ * @return  The thread's slot.
+ */
+static RequestSlot* client_slot()
+{
+    if (my_generation != generation) {
+        int slot = atomic_fetch_add(&next_slot, 1);
+        if (slot >= num_slots) {
+            handle_error("Error, too many delegation clients");
+        }
+        my_slot = &slots[slot];
+        my_generation = generation;
+    }
+    return my_slot;
+}
+
+/**
+ * @brief   Has the owner thread perform an operation and waits for it.
+ *
+ * @param   op       READ_OP, INCR_OP or DECR_OP.
+ * @param   id       ID of the requesting thread.
+ * @param   deadline Absolute deadline, or NULL to wait indefinitely.
+ * @param   value    Receives the sum read or left by the operation.
+ *
+ * @return  OP_OK, or OP_TIMEOUT if the request was withdrawn.
+ */
+int delegate_operation(int op, int id, const struct timespec* deadline,
+                       int* value)
+{
+    RequestSlot* slot = client_slot();
+    int spins = 0;
+
+    slot->op = op;
+    slot->id = id;
+    atomic_store_explicit(&slot->state, SLOT_PENDING, memory_order_release);
+
+    while (atomic_load_explicit(&slot->state,
+                                memory_order_acquire) != SLOT_DONE) {
+        if (++spins < spin_limit) {
+            cpu_relax();
+            continue;
+        }
+        spins = 0;
+
+        /* Withdraw the request if the owner has not taken it in time */
+        int expected = SLOT_PENDING;
+        if (deadline && deadline_passed(deadline) &&
+            atomic_compare_exchange_strong_explicit(&slot->state, &expected,
+                    SLOT_EMPTY, memory_order_relaxed, memory_order_relaxed)) {
+            return OP_TIMEOUT;
+        }
+        sched_yield();
+    }
+
+    *value = slot->result;
+    atomic_store_explicit(&slot->state, SLOT_EMPTY, memory_order_relaxed);
+    return OP_OK;
+}
+
+/* end delegation.c */
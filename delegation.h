@@ -0,0 +1,52 @@
+/**
+ * @file    delegation.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares delegation of shared data operations to an owner thread.
+ *
+ * @details In delegation mode a single owner thread is the only one that
+ *          touches the shared data. Other threads post their reads and
+ *          writes in per-client request slots and wait for the owner to
+ *          complete them, so the data stays in the owner's cache and no
+ *          lock ever moves between CPUs.
+ */
+
+#ifndef DELEGATION_H
+#define DELEGATION_H
+
+#include <time.h>
+
+/**
+ * @brief   Starts the owner thread.
+ *
+ * @details The owner is pinned to the last CPU when there is more than one.
+ *
+ * @param   max_clients Number of threads that may delegate operations.
+ */
+void start_delegation(int max_clients);
+
+/**
+ * @brief   Stops the owner thread once every client has finished.
+ */
+void stop_delegation();
+
+/**
+ * @brief   Has the owner thread perform an operation and waits for it.
+ *
+ * @details If the deadline passes before the owner has picked the request
+ *          up, the request is withdrawn. Once picked up, it is always
+ *          waited for.
+ *
+ * @param   op       READ_OP, INCR_OP or DECR_OP.
+ * @param   id       ID of the requesting thread.
+ * @param   deadline Absolute deadline, or NULL to wait indefinitely.
+ * @param   value    Receives the sum read or left by the operation.
+ *
+ * @return  OP_OK, or OP_TIMEOUT if the request was withdrawn.
+ */
+int delegate_operation(int op, int id, const struct timespec* deadline,
+                       int* value);
+
+#endif /* DELEGATION_H */
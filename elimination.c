@@ -0,0 +1,222 @@
+/**
+ * @file    elimination.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the elimination array for paired writers.
+ *
+ * @details Each slot holds a single state word. An offering writer moves an
+ *          empty slot to OFFER, tagged with its sign and ID. A writer of the
+ *          opposite sign moves it to MATCHED, tagged with its own ID. The
+ *          offerer then records the pair: it counts it in its slot, which
+ *          nobody else can touch until the offerer empties it again, and
+ *          applies it to the shared data right away so that every snapshot
+ *          taken mid-run includes it. The matcher waits for that to happen
+ *          so that the pair is logged before either writer returns.
+ */
+
+#include <sched.h>
+#include <stdatomic.h>
+#include "common.h"
+#include "shared_data.h"
+#include "queue_lock.h"
+#include "wal.h"
+#include "elimination.h"
+
+#define SLOT_EMPTY 0ULL
+#define SLOT_OFFER 1ULL
+#define SLOT_MATCHED 2ULL
+#define SLOT_STATE_MASK 3ULL
+#define SLOT_INCR_FLAG 4ULL
+#define SLOT_ID_SHIFT 32
+
+/**
+ * @struct  EliminationSlot
+ *
+ * @brief   One exchange slot, padded to its own cache line.
+ *
+ * @details The pair count is only written by the offerer while it owns the
+ *          slot in the MATCHED state.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) _Atomic unsigned long long state;
+    unsigned long pairs;        /* Pairs recorded in this slot           */
+} EliminationSlot;
+
+static EliminationSlot slots[ELIM_SLOTS];
+static _Thread_local unsigned int slot_seed;
+
+/**
+ * @brief   Packs a slot state word.
+ *
+ * @param   state     SLOT_OFFER or SLOT_MATCHED.
+ * @param   increment Sign of the write held in the slot.
+ * @param   thread_id ID of the thread that set the state.
+ *
+ * @return  The packed state word.
+ */
+static unsigned long long pack_state(unsigned long long state, int increment,
+                                     int thread_id)
+{
+    return state | (increment > 0 ? SLOT_INCR_FLAG : 0) |
+           ((unsigned long long)(unsigned)thread_id << SLOT_ID_SHIFT);
+}
+
+/**
+ * @brief   Extracts the thread ID from a packed state word.
+ *
+ * @param   word Packed state word.
+ *
+ * @return  The thread ID.
+ */
+static int state_id(unsigned long long word)
+{
+    return (int)(unsigned)(word >> SLOT_ID_SHIFT);
+}
+
+/**
+ * @brief   Records a completed pair and releases the offerer's slot.
+ *
+ * @param   slot      Slot the offer was matched in.
+ * @param   increment Sign of the offerer's write.
+ * @param   id        ID of the offerer.
+ * @param   partner   ID of the matching writer.
+ */
+static void record_pair(EliminationSlot* slot, int increment, int id,
+                        int partner)
+{
+    int incr_id = increment > 0 ? id : partner;
+    int decr_id = increment > 0 ? partner : id;
+
+    slot->pairs++;
+    apply_eliminated_pairs(1, next_write_seq(), incr_id, decr_id);
+    wal_append(WAL_PAIR, incr_id, decr_id);
+    atomic_store_explicit(&slot->state, SLOT_EMPTY, memory_order_release);
+}
+
+/**
+ * @brief   Waits for the offerer to record a pair this thread matched.
+ *
+ * @details Once this returns the pair has been appended to the log, so a
+ *          following wal_sync() covers the matcher's write as well.
+ *
+ * @param   slot    Slot the match was made in.
+ * @param   matched State word this thread stored in the slot.
+ */
+static void await_record(EliminationSlot* slot, unsigned long long matched)
+{
+    unsigned long polls = 0;
+    while (atomic_load_explicit(&slot->state, memory_order_acquire)
+           == matched) {
+        cpu_relax();
+        if (++polls % QUEUE_SPIN_LIMIT == 0) {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * @brief   Posts an offer in an empty slot and waits briefly for a partner.
+ *
+ * @param   slot      Empty slot to offer in.
+ * @param   increment Sign of the write.
+ * @param   thread_id ID of the writing thread.
+ *
+ * @return  ID of the partner, or -1 if the offer was withdrawn.
+ */
+static int offer(EliminationSlot* slot, int increment, int thread_id)
+{
+    unsigned long long expected = SLOT_EMPTY;
+    unsigned long long mine = pack_state(SLOT_OFFER, increment, thread_id);
+
+    if (!atomic_compare_exchange_strong_explicit(&slot->state, &expected,
+            mine, memory_order_acq_rel, memory_order_relaxed)) {
+        return -1;
+    }
+
+    for (int i = 0; i < ELIM_WAIT_SPINS; i++) {
+        unsigned long long word = atomic_load_explicit(&slot->state,
+                                                       memory_order_acquire);
+        if ((word & SLOT_STATE_MASK) == SLOT_MATCHED) {
+            record_pair(slot, increment, thread_id, state_id(word));
+            return state_id(word);
+        }
+        cpu_relax();
+    }
+
+    /* Withdraw, unless a partner matched us at the last moment */
+    expected = mine;
+    if (atomic_compare_exchange_strong_explicit(&slot->state, &expected,
+            SLOT_EMPTY, memory_order_acq_rel, memory_order_acquire)) {
+        return -1;
+    }
+    record_pair(slot, increment, thread_id, state_id(expected));
+    return state_id(expected);
+}
+
+/**
+ * @brief   Empties every slot and clears the pair counts for a new run.
+ */
+void elimination_init()
+{
+    for (int i = 0; i < ELIM_SLOTS; i++) {
+        atomic_store_explicit(&slots[i].state, SLOT_EMPTY,
+                              memory_order_relaxed);
+        slots[i].pairs = 0;
+    }
+}
+
+/**
+ * @brief   Attempts to cancel a write against an opposite concurrent write.
+ *
+ * @param   increment Write being performed (INCR_OP or DECR_OP).
+ * @param   thread_id ID of the writing thread.
+ *
+ * @return  ID of the partner thread, or -1 if no partner was found.
+ */
+int eliminate(int increment, int thread_id)
+{
+    if (!slot_seed) {
+        slot_seed = (unsigned int)(thread_id + 1) * 2654435761u
+                    ^ (unsigned int)(size_t)&slot_seed;
+    }
+    EliminationSlot* slot = &slots[rand_r(&slot_seed) % ELIM_SLOTS];
+    unsigned long long word = atomic_load_explicit(&slot->state,
+                                                   memory_order_acquire);
+
+    switch (word & SLOT_STATE_MASK) {
+    case SLOT_EMPTY:
+        return offer(slot, increment, thread_id);
+    case SLOT_OFFER:
+        /* Only a write of the opposite sign cancels the offer */
+        if (((word & SLOT_INCR_FLAG) != 0) == (increment > 0)) {
+            return -1;
+        }
+        if (atomic_compare_exchange_strong_explicit(&slot->state, &word,
+                pack_state(SLOT_MATCHED, increment, thread_id),
+                memory_order_acq_rel, memory_order_relaxed)) {
+            await_record(slot, pack_state(SLOT_MATCHED, increment, thread_id));
+            return state_id(word);
+        }
+        return -1;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief   Total number of eliminated incrementer/decrementer pairs.
+ *
+ * @return  Number of pairs cancelled so far.
+ */
+unsigned long eliminated_pairs()
+{
+    unsigned long total = 0;
+    for (int i = 0; i < ELIM_SLOTS; i++) {
+        total += slots[i].pairs;
+    }
+    return total;
+}
+
+/* end elimination.c */
@@ -0,0 +1,49 @@
+/**
+ * @file    elimination.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the elimination array for paired writers.
+ *
+ * @details An incrementer and a decrementer have opposite effects on the sum,
+ *          so when the writer lock is contended the two can meet in a slot
+ *          and cancel out without touching the sum. The pair is still
+ *          counted towards the writer totals as soon as it completes.
+ */
+
+#ifndef ELIMINATION_H
+#define ELIMINATION_H
+
+#define ELIM_SLOTS 8            /* Number of exchange slots                 */
+#define ELIM_WAIT_SPINS 512     /* Polls an offer waits for a partner       */
+
+/**
+ * @brief   Empties every slot and clears the pair counts for a new run.
+ *
+ * @details Must only be called while no writers are running.
+ */
+void elimination_init();
+
+/**
+ * @brief   Attempts to cancel a write against an opposite concurrent write.
+ *
+ * @details Picks a random slot and either matches a waiting offer of the
+ *          opposite sign, or posts an offer and waits briefly for one.
+ *
+ * @param   increment Write being performed (INCR_OP or DECR_OP).
+ * @param   thread_id ID of the writing thread.
+ *
+ * @return  ID of the partner thread, or -1 if no partner was found and the
+ *          write must go through the lock.
+ */
+int eliminate(int increment, int thread_id);
+
+/**
+ * @brief   Total number of eliminated incrementer/decrementer pairs.
+ *
+ * @return  Number of pairs cancelled so far.
+ */
+unsigned long eliminated_pairs();
+
+#endif /* ELIMINATION_H */
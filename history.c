@@ -0,0 +1,320 @@
+/**
+ * @file    history.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the time-series history of the shared sum.
+ *
+ * @details Entry positions count up forever and map onto the ring modulo
+ *          its capacity. Each slot's sequence number records which position
+ *          it holds: 2p + 1 while position p is being written and 2p + 2
+ *          once it is complete. A reader that wants position p accepts the
+ *          slot only if the sequence is 2p + 2 both before and after
+ *          copying it, so a torn or recycled slot is always detected.
+ */
+
+#include <stdatomic.h>
+#include "common.h"
+#include "utilities.h"
+#include "stats.h"
+#include "history.h"
+
+static ChangeRing* ring = NULL;
+static int recording_paused = 0;  /* Set while writes are not recorded */
+
+/**
+ * @brief   Computes the memory needed for a change ring.
+ *
+ * @param   capacity Number of entries retained.
+ *
+ * @return  Size of the ring in bytes.
+ */
+size_t change_ring_size(size_t capacity)
+{
+    return sizeof(ChangeRing) + capacity * sizeof(ChangeSlot);
+}
+
+/**
+ * @brief   Initializes an empty change ring.
+ *
+ * @param   ring     Memory of at least change_ring_size(capacity) bytes.
+ * @param   capacity Number of entries retained.
+ */
+void change_ring_init(ChangeRing* ring, size_t capacity)
+{
+    ring->capacity = capacity;
+    atomic_init(&ring->head, 0);
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&ring->slots[i].seq, 0);
+        atomic_init(&ring->slots[i].timestamp_ns, 0);
+        atomic_init(&ring->slots[i].sum, 0);
+        atomic_init(&ring->slots[i].writer_id, 0);
+    }
+}
+
+/**
+ * @brief   Appends an entry, overwriting the oldest once the ring is full.
+ *
+ * @param   ring      Ring to append to.
+ * @param   sum       Sum after the write.
+ * @param   writer_id ID of the writing thread.
+ */
+void change_ring_append(ChangeRing* ring, int sum, int writer_id)
+{
+    unsigned long pos = atomic_load_explicit(&ring->head,
+                                             memory_order_relaxed);
+    ChangeSlot* slot = &ring->slots[pos % ring->capacity];
+
+    /* Mark the slot as being rewritten before touching its fields */
+    atomic_store_explicit(&slot->seq, 2 * pos + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->timestamp_ns, monotonic_ns(),
+                          memory_order_relaxed);
+    atomic_store_explicit(&slot->sum, sum, memory_order_relaxed);
+    atomic_store_explicit(&slot->writer_id, writer_id, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->seq, 2 * pos + 2, memory_order_release);
+    atomic_store_explicit(&ring->head, pos + 1, memory_order_release);
+}
+
+/**
+ * @brief   Copies the entry at a position, if it is still retained.
+ *
+ * @param   ring  Ring to read.
+ * @param   pos   Position to read.
+ * @param   entry Receives the entry.
+ *
+ * @return  1 on success, 0 if the slot has been recycled.
+ */
+int change_ring_read(ChangeRing* ring, unsigned long pos, HistoryEntry* entry)
+{
+    ChangeSlot* slot = &ring->slots[pos % ring->capacity];
+    unsigned long seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    if (seq != 2 * pos + 2) {
+        return 0;
+    }
+    entry->timestamp_ns = atomic_load_explicit(&slot->timestamp_ns,
+                                               memory_order_relaxed);
+    entry->sum = atomic_load_explicit(&slot->sum, memory_order_relaxed);
+    entry->writer_id = atomic_load_explicit(&slot->writer_id,
+                                            memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->seq, memory_order_relaxed) == seq;
+}
+
+/**
+ * @brief   Finds the range of positions currently retained.
+ *
+ * @param   ring  Ring to inspect.
+ * @param   first Receives the oldest retained position.
+ * @param   end   Receives one past the newest position.
+ */
+void change_ring_bounds(ChangeRing* ring, unsigned long* first,
+                        unsigned long* end)
+{
+    *end = atomic_load_explicit(&ring->head, memory_order_acquire);
+    *first = *end > ring->capacity ? *end - ring->capacity : 0;
+}
+
+/**
+ * @brief   Allocates the history ring.
+ *
+ * @param   capacity Number of entries retained.
+ */
+void history_init(size_t capacity)
+{
+    ring = malloc(change_ring_size(capacity));
+    if (!ring) {
+        handle_error("Error allocating memory for history");
+    }
+    change_ring_init(ring, capacity);
+}
+
+/**
+ * @brief   Checks whether writes are being recorded.
+ *
+ * @return  1 if the history is enabled, 0 otherwise.
+ */
+int history_enabled()
+{
+    return ring != NULL;
+}
+
+/**
+ * @brief   Stops or resumes recording writes.
+ *
+ * @param   paused 1 to pause recording, 0 to resume it.
+ */
+void history_pause(int paused)
+{
+    recording_paused = paused;
+}
+
+/**
+ * @brief   Appends an entry for a committed write.
+ *
+ * @param   sum       Sum after the write.
+ * @param   writer_id ID of the writing thread.
+ */
+void history_append(int sum, int writer_id)
+{
+    if (ring && !recording_paused) {
+        change_ring_append(ring, sum, writer_id);
+    }
+}
+
+/**
+ * @brief   Finds the value of the sum at a point in time.
+ *
+ * @details Binary searches the retained positions. A recycled slot means
+ *          every position up to it has expired.
+ *
+ * @param   time_ns Monotonic time to look up.
+ * @param   entry   Receives the last entry written at or before the time.
+ *
+ * @return  1 on success, 0 if the time is older than the retained history.
+ */
+int history_value_at(long time_ns, HistoryEntry* entry)
+{
+    unsigned long lo, hi;
+    HistoryEntry probe;
+    int found = 0;
+
+    if (!ring) {
+        return 0;
+    }
+    change_ring_bounds(ring, &lo, &hi);
+    while (lo < hi) {
+        unsigned long mid = lo + (hi - lo) / 2;
+        if (!change_ring_read(ring, mid, &probe)) {
+            found = 0;
+            lo = mid + 1;
+        } else if (probe.timestamp_ns <= time_ns) {
+            *entry = probe;
+            found = 1;
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief   Summarises the entries written within a time window.
+ *
+ * @param   from_ns Start of the window, inclusive.
+ * @param   to_ns   End of the window, inclusive.
+ * @param   window  Receives the summary.
+ *
+ * @return  Number of entries in the window.
+ */
+unsigned long history_window(long from_ns, long to_ns, HistoryWindow* window)
+{
+    unsigned long lo, hi, end;
+    HistoryEntry entry;
+    double total = 0.0;
+
+    window->count = 0;
+    if (!ring) {
+        return 0;
+    }
+
+    /* Find the first entry at or after the start of the window */
+    change_ring_bounds(ring, &lo, &end);
+    hi = end;
+    while (lo < hi) {
+        unsigned long mid = lo + (hi - lo) / 2;
+        if (!change_ring_read(ring, mid, &entry) ||
+            entry.timestamp_ns < from_ns) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* Scan forward to the end of the window, skipping expired entries */
+    for (unsigned long pos = lo; pos < end; pos++) {
+        if (!change_ring_read(ring, pos, &entry)) {
+            continue;
+        }
+        if (entry.timestamp_ns > to_ns) {
+            break;
+        }
+        if (window->count == 0 || entry.sum < window->min) {
+            window->min = entry.sum;
+        }
+        if (window->count == 0 || entry.sum > window->max) {
+            window->max = entry.sum;
+        }
+        total += entry.sum;
+        window->count++;
+    }
+    if (window->count) {
+        window->avg = total / window->count;
+    }
+    return window->count;
+}
+
+/**
+ * @brief   Computes the rate of change of the sum over a time window.
+ *
+ * @param   from_ns Start of the window.
+ * @param   to_ns   End of the window.
+ * @param   rate    Receives the change in the sum per second.
+ *
+ * @return  1 on success, 0 if the window starts before the retained
+ *          history or is empty.
+ */
+int history_rate(long from_ns, long to_ns, double* rate)
+{
+    HistoryEntry start, end;
+
+    if (to_ns <= from_ns || !history_value_at(from_ns, &start) ||
+        !history_value_at(to_ns, &end)) {
+        return 0;
+    }
+    *rate = (end.sum - start.sum) * (double)NSEC_PER_SEC / (to_ns - from_ns);
+    return 1;
+}
+
+/**
+ * @brief   Prints a summary of the retained history.
+ */
+void print_history_report()
+{
+    unsigned long first, end;
+    HistoryEntry oldest, newest, middle;
+    HistoryWindow window;
+    double rate = 0.0;
+
+    change_ring_bounds(ring, &first, &end);
+    if (first == end || !change_ring_read(ring, first, &oldest) ||
+        !change_ring_read(ring, end - 1, &newest)) {
+        printf("\thistory empty\n");
+        return;
+    }
+    long span = newest.timestamp_ns - oldest.timestamp_ns;
+    history_window(oldest.timestamp_ns, newest.timestamp_ns, &window);
+    history_rate(oldest.timestamp_ns, newest.timestamp_ns, &rate);
+    history_value_at(oldest.timestamp_ns + span / 2, &middle);
+
+    printf("\thistory %lu writes over %.3f ms: min %d, max %d, avg %.1f, "
+            "rate %.0f/s, sum %d at the midpoint\n",
+            window.count, span / 1e6, window.min, window.max, window.avg,
+            rate, middle.sum);
+}
+
+/**
+ * @brief   Frees the history ring.
+ */
+void destroy_history()
+{
+    free(ring);
+    ring = NULL;
+}
+
+/* end history.c */
@@ -0,0 +1,197 @@
+/**
+ * @file    history.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the time-series history of the shared sum.
+ *
+ * @details Every committed write appends a (timestamp, sum, writer ID) entry
+ *          to a fixed-capacity ring, overwriting the oldest entry once it is
+ *          full. Entries are guarded by per-entry sequence locks, so queries
+ *          never block writers; a query that races with a wrap-around simply
+ *          treats the overwritten entries as expired. Timestamps are on the
+ *          monotonic clock, as returned by monotonic_ns().
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/**
+ * @struct  HistoryEntry
+ *
+ * @brief   The sum after one committed write.
+ */
+typedef struct {
+    long timestamp_ns;          /* When the write was applied           */
+    int sum;                    /* Sum after the write                  */
+    int writer_id;              /* ID of the writing thread             */
+} HistoryEntry;
+
+/**
+ * @struct  ChangeSlot
+ *
+ * @brief   Ring slot holding one entry under a sequence lock.
+ */
+typedef struct {
+    atomic_ulong seq;           /* Position held, 2p + 2 once complete  */
+    atomic_long timestamp_ns;
+    atomic_int sum;
+    atomic_int writer_id;
+} ChangeSlot;
+
+/**
+ * @struct  ChangeRing
+ *
+ * @brief   Single-producer ring of committed writes.
+ *
+ * @details Self-contained, so that it can also live in shared memory.
+ */
+typedef struct {
+    size_t capacity;            /* Number of slots                      */
+    atomic_ulong head;          /* Position of the next entry           */
+    ChangeSlot slots[];
+} ChangeRing;
+
+/**
+ * @struct  HistoryWindow
+ *
+ * @brief   Summary of the entries in a time window.
+ */
+typedef struct {
+    unsigned long count;        /* Entries in the window                */
+    int min;                    /* Smallest sum                         */
+    int max;                    /* Largest sum                          */
+    double avg;                 /* Mean sum over the entries            */
+} HistoryWindow;
+
+/**
+ * @brief   Computes the memory needed for a change ring.
+ *
+ * @param   capacity Number of entries retained.
+ *
+ * @return  Size of the ring in bytes.
+ */
+size_t change_ring_size(size_t capacity);
+
+/**
+ * @brief   Initializes an empty change ring.
+ *
+ * @param   ring     Memory of at least change_ring_size(capacity) bytes.
+ * @param   capacity Number of entries retained.
+ */
+void change_ring_init(ChangeRing* ring, size_t capacity);
+
+/**
+ * @brief   Appends an entry, overwriting the oldest once the ring is full.
+ *
+ * @details Must be called in write order by one writer at a time.
+ *
+ * @param   ring      Ring to append to.
+ * @param   sum       Sum after the write.
+ * @param   writer_id ID of the writing thread.
+ */
+void change_ring_append(ChangeRing* ring, int sum, int writer_id);
+
+/**
+ * @brief   Copies the entry at a position, if it is still retained.
+ *
+ * @param   ring  Ring to read.
+ * @param   pos   Position to read.
+ * @param   entry Receives the entry.
+ *
+ * @return  1 on success, 0 if the slot has been recycled.
+ */
+int change_ring_read(ChangeRing* ring, unsigned long pos, HistoryEntry* entry);
+
+/**
+ * @brief   Finds the range of positions currently retained.
+ *
+ * @param   ring  Ring to inspect.
+ * @param   first Receives the oldest retained position.
+ * @param   end   Receives one past the newest position.
+ */
+void change_ring_bounds(ChangeRing* ring, unsigned long* first,
+                        unsigned long* end);
+
+/**
+ * @brief   Allocates the history ring.
+ *
+ * @param   capacity Number of entries retained.
+ */
+void history_init(size_t capacity);
+
+/**
+ * @brief   Checks whether writes are being recorded.
+ *
+ * @return  1 if the history is enabled, 0 otherwise.
+ */
+int history_enabled();
+
+/**
+ * @brief   Stops or resumes recording writes.
+ *
+ * @details Must only be called while no writers are running.
+ *
+ * @param   paused 1 to pause recording, 0 to resume it.
+ */
+void history_pause(int paused);
+
+/**
+ * @brief   Appends an entry for a committed write.
+ *
+ * @details Must be called in write order by one writer at a time.
+ *
+ * @param   sum       Sum after the write.
+ * @param   writer_id ID of the writing thread.
+ */
+void history_append(int sum, int writer_id);
+
+/**
+ * @brief   Finds the value of the sum at a point in time.
+ *
+ * @param   time_ns Monotonic time to look up.
+ * @param   entry   Receives the last entry written at or before the time.
+ *
+ * @return  1 on success, 0 if the time is older than the retained history.
+ */
+int history_value_at(long time_ns, HistoryEntry* entry);
+
+/**
+ * @brief   Summarises the entries written within a time window.
+ *
+ * @param   from_ns Start of the window, inclusive.
+ * @param   to_ns   End of the window, inclusive.
+ * @param   window  Receives the summary; min, max and avg are only set
+ *                  when the window holds entries.
+ *
+ * @return  Number of entries in the window.
+ */
+unsigned long history_window(long from_ns, long to_ns, HistoryWindow* window);
+
+/**
+ * @brief   Computes the rate of change of the sum over a time window.
+ *
+ * @param   from_ns Start of the window.
+ * @param   to_ns   End of the window.
+ * @param   rate    Receives the change in the sum per second.
+ *
+ * @return  1 on success, 0 if the window starts before the retained
+ *          history or is empty.
+ */
+int history_rate(long from_ns, long to_ns, double* rate);
+
+/**
+ * @brief   Prints a summary of the retained history.
+ */
+void print_history_report();
+
+/**
+ * @brief   Frees the history ring.
+ */
+void destroy_history();
+
+#endif /* HISTORY_H */
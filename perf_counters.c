@@ -0,0 +1,196 @@
+/**
+ * @file    perf_counters.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements counter capture around a run.
+ *
+ * @details Each counter is opened on its own, not as a group, because
+ *          inherited counters cannot be read as a group. Counting kernel
+ *          activity is attempted first; if the kernel's paranoid setting
+ *          forbids it, a hardware counter is reopened for user space only.
+ *          Software counters are not, because context switches and CPU
+ *          migrations happen in the kernel and would always read 0; they
+ *          are reported as unavailable instead. getrusage() supplies CPU
+ *          times and a context switch count that is used when the software
+ *          counter is unavailable.
+ */
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "common.h"
+#include "perf_counters.h"
+
+/**
+ * @struct  PerfCounter
+ *
+ * @brief   One counter and its captured value.
+ */
+typedef struct {
+    const char* name;           /* Name printed in the report            */
+    unsigned int type;          /* PERF_TYPE_*                           */
+    unsigned long long config;  /* PERF_COUNT_*                          */
+    int fd;                     /* Open counter, or -1 if unavailable    */
+    int user_only;              /* Kernel activity could not be counted  */
+    int captured;               /* Value was read successfully           */
+    long long value;            /* Count captured by perf_end()          */
+} PerfCounter;
+
+static PerfCounter counters[PERF_NUM_COUNTERS] = {
+    { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1, 0, 0, 0 },
+    { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,
+      -1, 0, 0, 0 },
+    { "cache misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,
+      -1, 0, 0, 0 },
+    { "context switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES,
+      -1, 0, 0, 0 },
+    { "cpu migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS,
+      -1, 0, 0, 0 }
+};
+
+static struct rusage usage_start, usage_end;
+static struct timespec wall_start, wall_end;
+
+/**
+ * @brief   Opens one counter for this process and its future threads.
+ *
+ * @param   counter     Counter to open.
+ * @param   user_only   Exclude kernel and hypervisor activity.
+ *
+ * @return  The counter's file descriptor, or -1 on failure.
+ */
+static int open_counter(PerfCounter* counter, int user_only)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter->type;
+    attr.config = counter->config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = user_only;
+    attr.exclude_hv = user_only;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * @brief   Reads the elapsed time between two timestamps.
+ *
+ * @param   start Earlier timestamp.
+ * @param   end   Later timestamp.
+ *
+ * @return  Elapsed seconds.
+ */
+static double elapsed_sec(const struct timeval* start,
+                          const struct timeval* end)
+{
+    return (end->tv_sec - start->tv_sec) +
+           (end->tv_usec - start->tv_usec) / (double)USEC_PER_SEC;
+}
+
+/**
+ * @brief   Opens and starts the counters.
+ */
+void perf_begin()
+{
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        PerfCounter* counter = &counters[i];
+        counter->user_only = 0;
+        counter->captured = 0;
+        counter->fd = open_counter(counter, 0);
+        if (counter->fd < 0 && (errno == EACCES || errno == EPERM) &&
+            counter->type != PERF_TYPE_SOFTWARE) {
+            counter->user_only = 1;
+            counter->fd = open_counter(counter, 1);
+        }
+    }
+
+    getrusage(RUSAGE_SELF, &usage_start);
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (counters[i].fd >= 0) {
+            ioctl(counters[i].fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters[i].fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+/**
+ * @brief   Stops the counters and records their final values.
+ */
+void perf_end()
+{
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        PerfCounter* counter = &counters[i];
+        if (counter->fd < 0) {
+            continue;
+        }
+        ioctl(counter->fd, PERF_EVENT_IOC_DISABLE, 0);
+        counter->captured = read(counter->fd, &counter->value,
+                                 sizeof(counter->value))
+                            == sizeof(counter->value);
+        close(counter->fd);
+        counter->fd = -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    getrusage(RUSAGE_SELF, &usage_end);
+}
+
+/**
+ * @brief   Prints one counter line.
+ *
+ * @param   name   Counter name.
+ * @param   value  Captured count.
+ * @param   ops    Operations performed, for the per-operation figure.
+ * @param   source Where the value came from.
+ */
+static void print_counter(const char* name, long long value, long ops,
+                          const char* source)
+{
+    printf("\t%-18s %14lld  %10.2f per op  (%s)\n", name, value,
+            ops > 0 ? (double)value / ops : 0.0, source);
+}
+
+/**
+ * @brief   Prints the captured counters, in total and per operation.
+ *
+ * @param   ops Number of operations performed during the run.
+ */
+void print_perf_counters(long ops)
+{
+    long rusage_switches = (usage_end.ru_nvcsw - usage_start.ru_nvcsw) +
+                           (usage_end.ru_nivcsw - usage_start.ru_nivcsw);
+    double wall = (wall_end.tv_sec - wall_start.tv_sec) +
+                  (wall_end.tv_nsec - wall_start.tv_nsec) /
+                  (double)NSEC_PER_SEC;
+
+    printf("Performance counters over %ld operations:\n", ops);
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        PerfCounter* counter = &counters[i];
+        if (counter->captured) {
+            print_counter(counter->name, counter->value, ops,
+                    counter->user_only ? "perf, user only" : "perf");
+        } else if (counter->config == PERF_COUNT_SW_CONTEXT_SWITCHES &&
+                   counter->type == PERF_TYPE_SOFTWARE) {
+            print_counter(counter->name, rusage_switches, ops, "getrusage");
+        } else {
+            printf("\t%-18s %14s\n", counter->name, "unavailable");
+        }
+    }
+    printf("\twall time %.3f s, user time %.3f s, system time %.3f s\n",
+            wall, elapsed_sec(&usage_start.ru_utime, &usage_end.ru_utime),
+            elapsed_sec(&usage_start.ru_stime, &usage_end.ru_stime));
+    if (ops > 0 && wall > 0) {
+        printf("\tthroughput %.0f ops/s, %.1f ns per op\n",
+                ops / wall, wall * NSEC_PER_SEC / ops);
+    }
+}
+
+/* end perf_counters.c */
@@ -0,0 +1,43 @@
+/**
+ * @file    perf_counters.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares hardware and software counter capture for a run.
+ *
+ * @details Counts cycles, instructions, cache misses, context switches and
+ *          CPU migrations across all threads of a run using perf events.
+ *          Counters that the kernel refuses to open are reported as
+ *          unavailable, and context switches then fall back to getrusage().
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#define PERF_NUM_COUNTERS 5
+
+/**
+ * @brief   Opens and starts the counters.
+ *
+ * @details Must be called before the measured threads are created, since
+ *          only threads created afterwards inherit the counters.
+ */
+void perf_begin();
+
+/**
+ * @brief   Stops the counters and records their final values.
+ *
+ * @details Must be called after the measured threads have been joined, so
+ *          that their counts have been folded into the parent's counters.
+ */
+void perf_end();
+
+/**
+ * @brief   Prints the captured counters, in total and per operation.
+ *
+ * @param   ops Number of operations performed during the run.
+ */
+void print_perf_counters(long ops);
+
+#endif /* PERF_COUNTERS_H */
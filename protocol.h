@@ -0,0 +1,45 @@
+/**
+ * @file    protocol.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Wire format of the counter server.
+ *
+ * @details Requests and responses are fixed-size records in host byte order,
+ *          since the server only listens on a local Unix domain socket. A
+ *          client may write many requests before reading any responses;
+ *          responses come back in request order and echo the request tag.
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+#define PROTO_READ 0            /* Read the sum                         */
+#define PROTO_INCR 1            /* Increment the sum                    */
+#define PROTO_DECR 2            /* Decrement the sum                    */
+
+/**
+ * @struct  Request
+ *
+ * @brief   One operation sent by a client.
+ */
+typedef struct {
+    uint32_t tag;               /* Echoed back in the response          */
+    uint16_t op;                /* PROTO_READ, PROTO_INCR or PROTO_DECR */
+    uint16_t reserved;          /* Must be zero, or the server hangs up */
+} Request;
+
+/**
+ * @struct  Response
+ *
+ * @brief   Result of one operation.
+ */
+typedef struct {
+    uint32_t tag;               /* Tag of the matching request          */
+    int32_t value;              /* Sum read, or sum after the write     */
+} Response;
+
+#endif /* PROTOCOL_H */
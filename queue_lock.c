@@ -0,0 +1,55 @@
+/**
+ * @file    queue_lock.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements setup of the MCS queue lock.
+ *
+ * @details The acquire and release paths are static inline in
+ *          queue_lock.h. Acquirers swap themselves onto the tail of the
+ *          queue and spin on their own node until the previous holder
+ *          clears its flag. A waiter that has spun for too long yields the
+ *          CPU so that the lock holder can run when threads outnumber cores.
+ */
+
+#include "common.h"
+#include "queue_lock.h"
+
+/**
+ * @brief   Initializes a queue lock in the unlocked state.
+ *
+ * @param   lock    Lock to initialize.
+ * @param   backoff Backoff policy used by waiters.
+ */
+void queue_lock_init(QueueLock* lock, BackoffPolicy backoff)
+{
+    atomic_init(&lock->tail, NULL);
+    atomic_init(&lock->next_ticket, 0);
+    atomic_init(&lock->now_serving, 0);
+    lock->backoff = backoff;
+}
+
+/**
+ * @brief   Parses a backoff policy name.
+ *
+ * @param   name One of "none", "exp" or "prop".
+ * @param   backoff Receives the parsed policy.
+ *
+ * @return  1 on success, 0 if the name is not recognised.
+ */
+int parse_backoff(const char* name, BackoffPolicy* backoff)
+{
+    if (strcmp(name, "none") == 0) {
+        *backoff = BACKOFF_NONE;
+    } else if (strcmp(name, "exp") == 0) {
+        *backoff = BACKOFF_EXPONENTIAL;
+    } else if (strcmp(name, "prop") == 0) {
+        *backoff = BACKOFF_PROPORTIONAL;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+/* end queue_lock.c */
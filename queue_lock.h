@@ -0,0 +1,254 @@
+/**
+ * @file    queue_lock.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares an MCS queue lock with configurable backoff.
+ *
+ * @details Each waiting thread spins on a flag in its own queue node rather
+ *          than on a shared word, so lock handoff is FIFO and only touches
+ *          the cache line of the next waiter. The spin loop can back off
+ *          exponentially, in proportion to the waiter's queue position, or
+ *          not at all.
+ */
+
+#ifndef QUEUE_LOCK_H
+#define QUEUE_LOCK_H
+
+#include <sched.h>
+#include <stdatomic.h>
+#include "common.h"
+
+#define BACKOFF_MIN_SPINS 4         /* Initial exponential backoff delay    */
+#define BACKOFF_MAX_SPINS 1024      /* Cap on exponential backoff delay     */
+#define BACKOFF_SLOT_SPINS 64       /* Proportional delay per queued waiter */
+#define QUEUE_SPIN_LIMIT 256        /* Relax hints before yielding the CPU  */
+
+/**
+ * @enum    BackoffPolicy
+ *
+ * @brief   How a waiter paces polling of its queue node.
+ */
+typedef enum {
+    BACKOFF_NONE,           /* Poll continuously                           */
+    BACKOFF_EXPONENTIAL,    /* Double the delay after each failed poll     */
+    BACKOFF_PROPORTIONAL    /* Delay scales with the waiters queued ahead  */
+} BackoffPolicy;
+
+/**
+ * @struct  QueueNode
+ *
+ * @brief   Per-acquisition queue node owned by the waiting thread.
+ *
+ * @details Lives on the acquiring thread's stack for the duration of the
+ *          critical section and is padded to a cache line so that waiters
+ *          never share the line they spin on.
+ */
+typedef struct QueueNode {
+    _Alignas(CACHE_LINE_SIZE) struct QueueNode* _Atomic next;
+    atomic_int locked;          /* Set while the owner must keep waiting */
+    unsigned long ticket;       /* Arrival order, used by proportional   */
+} QueueNode;
+
+/**
+ * @struct  QueueLock
+ *
+ * @brief   MCS queue lock.
+ *
+ * @details The tail pointer is the only word every thread writes. The ticket
+ *          counters only estimate queue depth for proportional backoff and
+ *          live on their own cache lines.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) QueueNode* _Atomic tail;
+    _Alignas(CACHE_LINE_SIZE) atomic_ulong next_ticket;
+    _Alignas(CACHE_LINE_SIZE) atomic_ulong now_serving;
+    BackoffPolicy backoff;
+} QueueLock;
+
+/**
+ * @brief   Initializes a queue lock in the unlocked state.
+ *
+ * @param   lock    Lock to initialize.
+ * @param   backoff Backoff policy used by waiters.
+ */
+void queue_lock_init(QueueLock* lock, BackoffPolicy backoff);
+
+/**
+ * @brief   Parses a backoff policy name.
+ *
+ * @param   name One of "none", "exp" or "prop".
+ * @param   backoff Receives the parsed policy.
+ *
+ * @return  1 on success, 0 if the name is not recognised.
+ */
+int parse_backoff(const char* name, BackoffPolicy* backoff);
+
+/* The lock paths are defined here so that callers built with specialized
+ * kernels inline them rather than calling out to queue_lock.c */
+
+/**
+ * @brief   Hints to the CPU that the caller is in a spin-wait loop.
+ */
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief   Busy-waits for roughly the given number of relax cycles.
+ *
+ * @param   spins Number of relax hints to issue.
+ */
+static inline void spin_for(unsigned long spins)
+{
+    for (unsigned long i = 0; i < spins; i++) {
+        cpu_relax();
+    }
+}
+
+/**
+ * @brief   Delays a waiter between polls according to the lock's policy.
+ *
+ * @param   lock  Lock being waited on.
+ * @param   node  Waiter's queue node.
+ * @param   delay Current exponential delay, updated in place.
+ *
+ * @return  Number of relax hints spent waiting.
+ */
+static inline unsigned long backoff_wait(QueueLock* lock, QueueNode* node,
+                                         unsigned* delay)
+{
+    unsigned long spins = 1;
+
+    switch (lock->backoff) {
+    case BACKOFF_EXPONENTIAL:
+        spins = *delay;
+        if (*delay < BACKOFF_MAX_SPINS) {
+            *delay <<= 1;
+        }
+        break;
+    case BACKOFF_PROPORTIONAL: {
+        /* Waiters further back in the queue poll less often. Tickets are
+         * drawn before joining the queue, so a preempted waiter can be
+         * overtaken and find its ticket already served. */
+        long ahead = (long)(node->ticket -
+                atomic_load_explicit(&lock->now_serving,
+                                     memory_order_relaxed));
+        ahead = ahead < 1 ? 1 : ahead;
+        spins = ahead * BACKOFF_SLOT_SPINS;
+        if (spins > BACKOFF_MAX_SPINS) {
+            spins = BACKOFF_MAX_SPINS;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    spin_for(spins);
+    return spins;
+}
+
+/**
+ * @brief   Acquires the lock, waiting in FIFO order behind earlier callers.
+ *
+ * @details Links the node behind the current tail and spins on the node's
+ *          own flag, which only the predecessor writes on release.
+ *
+ * @param   lock Lock to acquire.
+ * @param   node Caller-owned node, valid until the matching release.
+ */
+static inline void queue_lock_acquire(QueueLock* lock, QueueNode* node)
+{
+    QueueNode* prev;
+    unsigned delay = BACKOFF_MIN_SPINS;
+    unsigned long spins = 0;
+
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&node->locked, 1, memory_order_relaxed);
+    node->ticket = atomic_fetch_add_explicit(&lock->next_ticket, 1,
+                                             memory_order_relaxed);
+
+    /* Join the queue; an empty queue means the lock is ours */
+    prev = atomic_exchange_explicit(&lock->tail, node, memory_order_acq_rel);
+    if (!prev) {
+        return;
+    }
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+
+    /* Spin locally until the predecessor hands the lock over */
+    while (atomic_load_explicit(&node->locked, memory_order_acquire)) {
+        spins += backoff_wait(lock, node, &delay);
+        if (spins >= QUEUE_SPIN_LIMIT) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+/**
+ * @brief   Acquires the lock only if no other thread holds or awaits it.
+ *
+ * @param   lock Lock to acquire.
+ * @param   node Caller-owned node, valid until the matching release.
+ *
+ * @return  1 if the lock was acquired, 0 otherwise.
+ */
+static inline int queue_lock_try_acquire(QueueLock* lock, QueueNode* node)
+{
+    QueueNode* expected = NULL;
+
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&node->locked, 0, memory_order_relaxed);
+
+    if (!atomic_compare_exchange_strong_explicit(&lock->tail, &expected, node,
+            memory_order_acq_rel, memory_order_relaxed)) {
+        return 0;
+    }
+    node->ticket = atomic_fetch_add_explicit(&lock->next_ticket, 1,
+                                             memory_order_relaxed);
+    return 1;
+}
+
+/**
+ * @brief   Releases the lock, handing it to the next queued waiter if any.
+ *
+ * @details If no successor is linked yet, either the queue is empty and the
+ *          tail is reset, or a successor is mid-enqueue and we wait for it
+ *          to link itself before passing the lock on.
+ *
+ * @param   lock Lock to release.
+ * @param   node Node passed to the matching acquire.
+ */
+static inline void queue_lock_release(QueueLock* lock, QueueNode* node)
+{
+    QueueNode* next = atomic_load_explicit(&node->next, memory_order_acquire);
+
+    atomic_fetch_add_explicit(&lock->now_serving, 1, memory_order_relaxed);
+
+    if (!next) {
+        QueueNode* expected = node;
+        if (atomic_compare_exchange_strong_explicit(&lock->tail, &expected,
+                NULL, memory_order_acq_rel, memory_order_relaxed)) {
+            return;
+        }
+
+        /* A successor swapped in but has not linked itself yet */
+        unsigned long polls = 0;
+        while (!(next = atomic_load_explicit(&node->next,
+                                             memory_order_acquire))) {
+            cpu_relax();
+            if (++polls % QUEUE_SPIN_LIMIT == 0) {
+                sched_yield();
+            }
+        }
+    }
+    atomic_store_explicit(&next->locked, 0, memory_order_release);
+}
+
+#endif /* QUEUE_LOCK_H */
@@ -0,0 +1,417 @@
+/**
+ * @file    regress.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the performance regression gate.
+ *
+ * @details Every scenario fixes its thread mix and synchronization options,
+ *          so a suite run depends only on the code and the machine, apart
+ *          from scheduling noise between trials. Differences are tested
+ *          with Welch's t-test at 95% confidence, using the smaller
+ *          sample's degrees of freedom to stay conservative. Tail latency
+ *          is read from a histogram, so its standard error is never taken
+ *          to be below REGRESS_TAIL_MIN_SE of the baseline, even when
+ *          every trial landed on the same value.
+ *
+ *          The baseline is a small JSON document written by this file, and
+ *          the reader only understands that layout. Suite writes are kept
+ *          out of the write-ahead log and the history, so baselines
+ *          recorded with and without -p or -H are comparable.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include "common.h"
+#include "utilities.h"
+#include "arg_parser.h"
+#include "resources.h"
+#include "stats.h"
+#include "thread_operations.h"
+#include "regress.h"
+
+#define BASELINE_MAX_SIZE 65536
+
+/**
+ * @struct  Scenario
+ *
+ * @brief   One workload of the regression suite.
+ */
+typedef struct {
+    const char* name;           /* Name in the baseline and report      */
+    int writer_lock;            /* WRITER_LOCK_* synchronization scheme */
+    BackoffPolicy backoff;      /* Spin policy for the MCS writer lock  */
+    int elimination;            /* Cancel out contended writer pairs    */
+    int incrementers;
+    int decrementers;
+    int readers;
+} Scenario;
+
+/**
+ * @struct  Sample
+ *
+ * @brief   Mean and spread of a metric over the trials of a scenario.
+ */
+typedef struct {
+    int n;                      /* Number of trials                     */
+    double mean;
+    double sd;                  /* Sample standard deviation            */
+} Sample;
+
+/**
+ * @struct  ScenarioResult
+ *
+ * @brief   Throughput and tail latency of a scenario.
+ */
+typedef struct {
+    Sample throughput;          /* Operations per second                */
+    Sample tail_us;             /* TAIL_PERCENTILE latency, microseconds */
+} ScenarioResult;
+
+static const Scenario suite[] = {
+    { "sem-read-heavy", WRITER_LOCK_SEM, BACKOFF_NONE, 0, 1, 1, 6 },
+    { "sem-write-heavy", WRITER_LOCK_SEM, BACKOFF_NONE, 0, 3, 3, 2 },
+    { "mcs-write-heavy", WRITER_LOCK_MCS, BACKOFF_EXPONENTIAL, 0, 3, 3, 2 },
+    { "elim-writers", WRITER_LOCK_SEM, BACKOFF_NONE, 1, 4, 4, 0 },
+    { "delegate-mixed", WRITER_LOCK_DELEGATE, BACKOFF_NONE, 0, 2, 2, 4 }
+};
+
+#define SUITE_SIZE (int)(sizeof(suite) / sizeof(*suite))
+
+/* Two-sided 95% critical values of Student's t for 1 to 10 degrees of
+ * freedom; larger samples use the normal approximation */
+static const double t_critical[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228
+};
+
+/**
+ * @brief   Looks up the 95% critical value of Student's t.
+ *
+ * @param   df Degrees of freedom.
+ *
+ * @return  The critical value.
+ */
+static double t_value(int df)
+{
+    if (df < 1) {
+        return INFINITY;
+    }
+    return df <= 10 ? t_critical[df - 1] : 1.96;
+}
+
+/**
+ * @brief   Computes the mean and sample standard deviation of values.
+ *
+ * @param   values Trial values.
+ * @param   n      Number of trials.
+ * @param   sample Receives the summary.
+ */
+static void summarise(const double values[], int n, Sample* sample)
+{
+    double total = 0.0, squares = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        total += values[i];
+    }
+    sample->n = n;
+    sample->mean = total / n;
+    for (int i = 0; i < n; i++) {
+        squares += (values[i] - sample->mean) * (values[i] - sample->mean);
+    }
+    sample->sd = n > 1 ? sqrt(squares / (n - 1)) : 0.0;
+}
+
+/**
+ * @brief   Runs every trial of one scenario.
+ *
+ * @param   scenario Scenario to run.
+ * @param   result   Receives the summarised results.
+ */
+static void run_scenario(const Scenario* scenario, ScenarioResult* result)
+{
+    Options* options = get_options();
+    double throughput[REGRESS_TRIALS], tail_us[REGRESS_TRIALS];
+    Measurement run;
+
+    options->writer_lock = scenario->writer_lock;
+    options->backoff = scenario->backoff;
+    options->elimination = scenario->elimination;
+    configure_writer_lock();
+
+    for (int i = 0; i < REGRESS_TRIALS; i++) {
+        measure_workers(scenario->incrementers, scenario->decrementers,
+                        scenario->readers, REGRESS_TRIAL_MS, &run);
+        throughput[i] = run.throughput;
+        tail_us[i] = run.tail_ns / (double)NSEC_PER_USEC;
+    }
+    summarise(throughput, REGRESS_TRIALS, &result->throughput);
+    summarise(tail_us, REGRESS_TRIALS, &result->tail_us);
+}
+
+/**
+ * @brief   Runs the whole suite.
+ *
+ * @param   results Receives one result per scenario.
+ */
+static void run_suite(ScenarioResult results[])
+{
+    Options* options = get_options();
+    int max_threads = 0;
+
+    /* Only the scenarios decide how the threads synchronize */
+    options->deadline_us = 0;
+    options->affinity = AFFINITY_NONE;
+    for (int s = 0; s < SUITE_SIZE; s++) {
+        int threads = suite[s].incrementers + suite[s].decrementers +
+                      suite[s].readers;
+        max_threads = threads > max_threads ? threads : max_threads;
+    }
+    begin_calibration(max_threads);
+
+    printf("Running %d scenarios, %d trials of %d ms each\n",
+            SUITE_SIZE, REGRESS_TRIALS, REGRESS_TRIAL_MS);
+    for (int s = 0; s < SUITE_SIZE; s++) {
+        run_scenario(&suite[s], &results[s]);
+    }
+    end_calibration();
+}
+
+/**
+ * @brief   Runs the suite and records it as the new baseline.
+ *
+ * @param   path JSON file to write.
+ */
+void record_baseline(const char* path)
+{
+    ScenarioResult results[SUITE_SIZE];
+
+    run_suite(results);
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        char errorMsg[MAX_STRING * 2];
+        snprintf(errorMsg, sizeof(errorMsg), "Error creating baseline %s: %s",
+                path, strerror(errno));
+        handle_error(errorMsg);
+    }
+    fprintf(file, "{\n  \"trials\": %d,\n  \"trial_ms\": %d,\n"
+            "  \"scenarios\": [\n", REGRESS_TRIALS, REGRESS_TRIAL_MS);
+    for (int s = 0; s < SUITE_SIZE; s++) {
+        fprintf(file, "    { \"name\": \"%s\", \"trials\": %d, "
+                "\"throughput_mean\": %.1f, \"throughput_sd\": %.1f, "
+                "\"tail_us_mean\": %.3f, \"tail_us_sd\": %.3f }%s\n",
+                suite[s].name, results[s].throughput.n,
+                results[s].throughput.mean, results[s].throughput.sd,
+                results[s].tail_us.mean, results[s].tail_us.sd,
+                s < SUITE_SIZE - 1 ? "," : "");
+        printf("%-16s %12.0f ops/s +/- %4.1f%%  p%g %8.1f us\n",
+                suite[s].name, results[s].throughput.mean,
+                100.0 * results[s].throughput.sd /
+                results[s].throughput.mean,
+                TAIL_PERCENTILE, results[s].tail_us.mean);
+    }
+    fprintf(file, "  ]\n}\n");
+    if (fclose(file) != 0) {
+        handle_error("Error writing baseline");
+    }
+    printf("Baseline saved to %s\n", path);
+}
+
+/**
+ * @brief   Reads a number following a key within part of a JSON document.
+ *
+ * @param   start Start of the JSON object.
+ * @param   end   End of the JSON object.
+ * @param   key   Key to look for, without quotes.
+ * @param   value Receives the number.
+ *
+ * @return  1 on success, 0 if the key is missing.
+ */
+static int json_number(const char* start, const char* end, const char* key,
+                       double* value)
+{
+    char quoted[MAX_STRING];
+    snprintf(quoted, sizeof(quoted), "\"%s\":", key);
+
+    const char* found = strstr(start, quoted);
+    if (!found || found >= end) {
+        return 0;
+    }
+    *value = strtod(found + strlen(quoted), NULL);
+    return 1;
+}
+
+/**
+ * @brief   Finds a scenario's entry in a baseline document.
+ *
+ * @param   json   Baseline document.
+ * @param   name   Scenario name.
+ * @param   result Receives the recorded results.
+ *
+ * @return  1 on success, 0 if the scenario is not in the baseline. Exits
+ *          if the entry has no trials or a negative spread.
+ */
+static int find_baseline(const char* json, const char* name,
+                         ScenarioResult* result)
+{
+    char quoted[MAX_STRING];
+    double trials;
+
+    snprintf(quoted, sizeof(quoted), "\"name\": \"%s\"", name);
+    const char* start = strstr(json, quoted);
+    const char* end = start ? strchr(start, '}') : NULL;
+    if (!end ||
+        !json_number(start, end, "trials", &trials) ||
+        !json_number(start, end, "throughput_mean",
+                     &result->throughput.mean) ||
+        !json_number(start, end, "throughput_sd", &result->throughput.sd) ||
+        !json_number(start, end, "tail_us_mean", &result->tail_us.mean) ||
+        !json_number(start, end, "tail_us_sd", &result->tail_us.sd)) {
+        return 0;
+    }
+    if (trials < 1 || result->throughput.sd < 0 || result->tail_us.sd < 0) {
+        char errorMsg[MAX_STRING * 2];
+        snprintf(errorMsg, sizeof(errorMsg),
+                "Invalid baseline entry for scenario %s", name);
+        handle_error(errorMsg);
+    }
+    result->throughput.n = result->tail_us.n = (int)trials;
+    return 1;
+}
+
+/**
+ * @brief   Reads a whole baseline document.
+ *
+ * @details Exits if the file does not fit in the buffer, rather than
+ *          parsing part of the document.
+ *
+ * @param   path JSON file to read.
+ * @param   json Buffer of BASELINE_MAX_SIZE bytes receiving the document.
+ */
+static void load_baseline(const char* path, char* json)
+{
+    char errorMsg[MAX_STRING * 2];
+    FILE* file = fopen(path, "r");
+
+    if (!file) {
+        snprintf(errorMsg, sizeof(errorMsg), "Error opening baseline %s: %s",
+                path, strerror(errno));
+        handle_error(errorMsg);
+    }
+    size_t length = fread(json, 1, BASELINE_MAX_SIZE - 1, file);
+    if (ferror(file)) {
+        snprintf(errorMsg, sizeof(errorMsg), "Error reading baseline %s",
+                path);
+        handle_error(errorMsg);
+    }
+    if (length == BASELINE_MAX_SIZE - 1 && fgetc(file) != EOF) {
+        snprintf(errorMsg, sizeof(errorMsg),
+                "Baseline %s is larger than %d bytes", path,
+                BASELINE_MAX_SIZE - 1);
+        handle_error(errorMsg);
+    }
+    json[length] = '\0';
+    fclose(file);
+}
+
+/**
+ * @brief   Judges the change of a metric against its baseline.
+ *
+ * @param   base      Baseline sample.
+ * @param   current   Current sample.
+ * @param   threshold Allowed change in percent, in the bad direction.
+ * @param   worse     +1 if larger values are worse, -1 if smaller are.
+ * @param   min_se    Smallest standard error assumed, as a fraction of the
+ *                    baseline mean.
+ * @param   change    Receives the change in percent.
+ *
+ * @return  "REGRESSED", "improved", "noise" or "ok".
+ */
+static const char* judge(const Sample* base, const Sample* current,
+                         double threshold, int worse, double min_se,
+                         double* change)
+{
+    double diff = current->mean - base->mean;
+    int df = (current->n < base->n ? current->n : base->n) - 1;
+    int significant = 0;
+
+    if (df >= 1) {
+        double se = sqrt(current->sd * current->sd / current->n +
+                         base->sd * base->sd / base->n);
+        if (se < min_se * fabs(base->mean)) {
+            se = min_se * fabs(base->mean);
+        }
+        significant = fabs(diff) > t_value(df) * se;
+    }
+
+    *change = base->mean != 0.0 ? 100.0 * diff / base->mean : 0.0;
+    if (worse * *change > threshold) {
+        return significant ? "REGRESSED" : "noise";
+    } else if (-worse * *change > threshold && significant) {
+        return "improved";
+    }
+    return "ok";
+}
+
+/**
+ * @brief   Runs the suite and compares it with a recorded baseline.
+ *
+ * @param   path      JSON file written by record_baseline().
+ * @param   threshold Allowed throughput loss in percent.
+ *
+ * @return  Number of scenarios that regressed.
+ */
+int check_baseline(const char* path, double threshold)
+{
+    static char json[BASELINE_MAX_SIZE];
+    ScenarioResult results[SUITE_SIZE];
+    int regressions = 0;
+
+    load_baseline(path, json);
+
+    /* Reject a malformed baseline before spending time on the suite */
+    for (int s = 0; s < SUITE_SIZE; s++) {
+        ScenarioResult base;
+        find_baseline(json, suite[s].name, &base);
+    }
+    run_suite(results);
+
+    printf("%-16s %12s %12s %8s %-9s  %9s %9s %8s\n", "scenario",
+            "base ops/s", "ops/s", "change", "", "base p99", "p99",
+            "change");
+    for (int s = 0; s < SUITE_SIZE; s++) {
+        ScenarioResult base;
+        double tp_change, tail_change;
+
+        if (!find_baseline(json, suite[s].name, &base)) {
+            printf("%-16s %12s %12.0f  not in baseline\n", suite[s].name,
+                    "-", results[s].throughput.mean);
+            continue;
+        }
+        const char* tp = judge(&base.throughput, &results[s].throughput,
+                               threshold, -1, 0.0, &tp_change);
+        const char* tail = judge(&base.tail_us, &results[s].tail_us,
+                                 REGRESS_TAIL_THRESHOLD, 1,
+                                 REGRESS_TAIL_MIN_SE, &tail_change);
+        printf("%-16s %12.0f %12.0f %+7.1f%% %-9s  %9.1f %9.1f %+7.1f%% %s\n",
+                suite[s].name, base.throughput.mean,
+                results[s].throughput.mean, tp_change, tp,
+                base.tail_us.mean, results[s].tail_us.mean, tail_change,
+                tail);
+        if (strcmp(tp, "REGRESSED") == 0 || strcmp(tail, "REGRESSED") == 0) {
+            regressions++;
+        }
+    }
+
+    if (regressions) {
+        printf("%d of %d scenarios regressed (throughput threshold %.1f%%, "
+                "p%g threshold %.1f%%)\n", regressions, SUITE_SIZE,
+                threshold, TAIL_PERCENTILE, REGRESS_TAIL_THRESHOLD);
+    } else {
+        printf("No regressions against %s\n", path);
+    }
+    return regressions;
+}
+
+/* end regress.c */
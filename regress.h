@@ -0,0 +1,41 @@
+/**
+ * @file    regress.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the performance regression gate.
+ *
+ * @details Runs a fixed suite of workloads several times each and
+ *          compares mean throughput and tail latency with a JSON baseline
+ *          recorded earlier. A scenario only counts as regressed when the
+ *          change is both larger than the threshold and statistically
+ *          significant given the spread of the trials.
+ */
+
+#ifndef REGRESS_H
+#define REGRESS_H
+
+#define REGRESS_TRIALS 5            /* Trials per scenario                */
+#define REGRESS_TRIAL_MS 200        /* Length of each trial               */
+#define REGRESS_TAIL_THRESHOLD 25.0 /* Allowed tail latency growth, %     */
+#define REGRESS_TAIL_MIN_SE 0.05    /* Tail error floor, share of mean    */
+
+/**
+ * @brief   Runs the suite and records it as the new baseline.
+ *
+ * @param   path JSON file to write.
+ */
+void record_baseline(const char* path);
+
+/**
+ * @brief   Runs the suite and compares it with a recorded baseline.
+ *
+ * @param   path      JSON file written by record_baseline().
+ * @param   threshold Allowed throughput loss in percent.
+ *
+ * @return  Number of scenarios that regressed.
+ */
+int check_baseline(const char* path, double threshold);
+
+#endif /* REGRESS_H */
@@ -0,0 +1,300 @@
+/**
+ * @file    replication.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements read replicas fed by a shared-memory change stream.
+ *
+ * @details The stream is a single-producer change ring mapped from a POSIX
+ *          shared memory object, so replicas in other processes could map
+ *          it by name as well. Each replica thread owns its cache line and
+ *          its lag counters. Lag is sampled every time a replica finds new
+ *          changes, as the number of changes waiting and the age of the
+ *          oldest one.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "common.h"
+#include "utilities.h"
+#include "shared_data.h"
+#include "queue_lock.h"
+#include "history.h"
+#include "stats.h"
+#include "replication.h"
+
+/**
+ * @struct  Replica
+ *
+ * @brief   A local copy of the sum and its lag statistics.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_int sum;   /* Copy served to readers */
+    unsigned long applied;      /* Position of the next change to apply */
+    unsigned long samples;      /* Times new changes were found         */
+    unsigned long total_lag_ops;
+    unsigned long max_lag_ops;
+    long total_lag_ns;
+    long max_lag_ns;
+    unsigned long resyncs;      /* Times the replica fell a ring behind */
+    pthread_t thread;
+} Replica;
+
+static ChangeRing* stream = NULL;
+static char stream_name[MAX_STRING];
+static Replica* replicas = NULL;
+static int num_replicas = 0;
+static atomic_int replicas_running = 0;
+static int spin_limit = QUEUE_SPIN_LIMIT;
+
+/**
+ * @brief   Reports a failed system call in replication and exits.
+ *
+ * @param   what Description of the failed operation.
+ */
+static void replication_error(const char* what)
+{
+    char errorMsg[MAX_STRING * 2];
+    snprintf(errorMsg, sizeof(errorMsg), "Replication: %s: %s",
+            what, strerror(errno));
+    handle_error(errorMsg);
+}
+
+/**
+ * @brief   Records the lag of a replica that found changes waiting.
+ *
+ * @param   replica Replica to update.
+ * @param   ops     Number of changes waiting.
+ * @param   oldest  Oldest waiting change.
+ */
+static void record_lag(Replica* replica, unsigned long ops,
+                       const HistoryEntry* oldest)
+{
+    long lag_ns = monotonic_ns() - oldest->timestamp_ns;
+
+    replica->samples++;
+    replica->total_lag_ops += ops;
+    replica->total_lag_ns += lag_ns;
+    if (ops > replica->max_lag_ops) {
+        replica->max_lag_ops = ops;
+    }
+    if (lag_ns > replica->max_lag_ns) {
+        replica->max_lag_ns = lag_ns;
+    }
+}
+
+/**
+ * @brief   Applies the changes a replica has not seen yet.
+ *
+ * @param   replica Replica to bring up to date.
+ *
+ * @return  Number of changes applied.
+ */
+static unsigned long catch_up(Replica* replica)
+{
+    unsigned long first, end;
+    HistoryEntry entry;
+
+    change_ring_bounds(stream, &first, &end);
+    if (replica->applied == end) {
+        return 0;
+    }
+
+    /* Changes carry the whole sum, so a lapped replica skips to the newest;
+     * the oldest change still retained then bounds how old its copy was */
+    unsigned long lag_ops = end - replica->applied;
+    if (replica->applied < first ||
+        !change_ring_read(stream, replica->applied, &entry)) {
+        replica->resyncs++;
+        replica->applied = end - 1;
+        if (!change_ring_read(stream, first, &entry) &&
+            !change_ring_read(stream, replica->applied, &entry)) {
+            return 0;
+        }
+    }
+    record_lag(replica, lag_ops, &entry);
+
+    unsigned long applied = 0;
+    while (replica->applied < end &&
+           change_ring_read(stream, replica->applied, &entry)) {
+        atomic_store_explicit(&replica->sum, entry.sum, memory_order_relaxed);
+        replica->applied++;
+        applied++;
+    }
+    return applied;
+}
+
+/**
+ * @brief   Replica thread body: follows the change stream until stopped.
+ *
+ * @param   arg Pointer to the thread's Replica.
+ *
+ * @return  NULL
+ */
+static void* replica_thread(void* arg)
+{
+    Replica* replica = arg;
+    int idle = 0;
+
+    while (atomic_load_explicit(&replicas_running, memory_order_relaxed)) {
+        if (catch_up(replica)) {
+            idle = 0;
+        } else if (++idle >= spin_limit) {
+            sched_yield();
+            idle = 0;
+        } else {
+            cpu_relax();
+        }
+    }
+
+    /* Apply whatever was published before the stop */
+    while (catch_up(replica)) {
+    }
+    return NULL;
+}
+
+/**
+ * @brief   Creates the change stream in shared memory.
+ */
+static void open_stream()
+{
+    size_t size = change_ring_size(REPLICA_RING_ENTRIES);
+
+    snprintf(stream_name, sizeof(stream_name), REPLICA_SHM_NAME,
+            (int)getpid());
+    int fd = shm_open(stream_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        replication_error("creating change stream");
+    }
+    if (ftruncate(fd, size) != 0) {
+        replication_error("sizing change stream");
+    }
+    stream = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stream == MAP_FAILED) {
+        stream = NULL;
+        replication_error("mapping change stream");
+    }
+    change_ring_init(stream, REPLICA_RING_ENTRIES);
+}
+
+/**
+ * @brief   Creates the change stream and starts the replica threads.
+ *
+ * @param   count Number of replicas.
+ */
+void start_replicas(int count)
+{
+    int sum = get_shared_data()->sum;
+
+    replicas = aligned_alloc(CACHE_LINE_SIZE, count * sizeof(Replica));
+    if (!replicas) {
+        handle_error("Error allocating memory for replicas");
+    }
+    open_stream();
+
+    /* With one CPU, spinning only delays the writers being followed */
+    spin_limit = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? QUEUE_SPIN_LIMIT : 1;
+
+    num_replicas = count;
+    atomic_store(&replicas_running, 1);
+    for (int i = 0; i < count; i++) {
+        memset(&replicas[i], 0, sizeof(Replica));
+        atomic_init(&replicas[i].sum, sum);
+        if (pthread_create(&replicas[i].thread, NULL, replica_thread,
+                           &replicas[i]) != 0) {
+            handle_error("Error creating replica thread");
+        }
+    }
+}
+
+/**
+ * @brief   Lets the replicas apply the remaining changes, stops them and
+ *          removes the change stream.
+ */
+void stop_replicas()
+{
+    if (!atomic_exchange(&replicas_running, 0)) {
+        return;
+    }
+    for (int i = 0; i < num_replicas; i++) {
+        pthread_join(replicas[i].thread, NULL);
+    }
+    munmap(stream, change_ring_size(REPLICA_RING_ENTRIES));
+    shm_unlink(stream_name);
+    stream = NULL;
+}
+
+/**
+ * @brief   Frees the replicas once their report has been printed.
+ */
+void destroy_replicas()
+{
+    stop_replicas();
+    free(replicas);
+    replicas = NULL;
+    num_replicas = 0;
+}
+
+/**
+ * @brief   Checks whether replication is in use.
+ *
+ * @return  1 if replicas have been started, 0 otherwise.
+ */
+int replicas_enabled()
+{
+    return num_replicas > 0;
+}
+
+/**
+ * @brief   Publishes a committed write to the change stream.
+ *
+ * @param   sum       Sum after the write.
+ * @param   writer_id ID of the writing thread.
+ */
+void replication_publish(int sum, int writer_id)
+{
+    if (stream) {
+        change_ring_append(stream, sum, writer_id);
+    }
+}
+
+/**
+ * @brief   Reads the sum from a replica without any locking.
+ *
+ * @param   reader_id ID of the reading thread, used to pick the replica.
+ *
+ * @return  The replica's copy of the sum.
+ */
+int replica_read(int reader_id)
+{
+    Replica* replica = &replicas[reader_id % num_replicas];
+    return atomic_load_explicit(&replica->sum, memory_order_relaxed);
+}
+
+/**
+ * @brief   Prints how far each replica lagged behind the primary.
+ */
+void print_replica_report()
+{
+    printf("Replica lag behind the primary:\n");
+    for (int i = 0; i < num_replicas; i++) {
+        Replica* replica = &replicas[i];
+        unsigned long samples = replica->samples ? replica->samples : 1;
+        printf("\treplica %d sum %d: lag avg %.1f ops %.1f us, "
+                "max %lu ops %.1f us, %lu resyncs\n",
+                i, atomic_load(&replica->sum),
+                (double)replica->total_lag_ops / samples,
+                replica->total_lag_ns / (double)samples / NSEC_PER_USEC,
+                replica->max_lag_ops,
+                replica->max_lag_ns / (double)NSEC_PER_USEC,
+                replica->resyncs);
+    }
+}
+
+/* end replication.c */
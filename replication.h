@@ -0,0 +1,72 @@
+/**
+ * @file    replication.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares read replicas fed by a shared-memory change stream.
+ *
+ * @details Every committed write is published to a change ring in a POSIX
+ *          shared memory object. Replica threads follow the ring, each
+ *          keeping a local copy of the sum, and readers are served from a
+ *          replica instead of taking the reader lock on the primary. Since
+ *          each change carries the whole sum, a replica that falls a full
+ *          ring behind catches up by jumping to the newest change.
+ */
+
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#define REPLICA_RING_ENTRIES 4096   /* Changes held in the stream       */
+#define REPLICA_SHM_NAME "/a2-changes-%d"   /* Stream name, by process ID */
+
+/**
+ * @brief   Creates the change stream and starts the replica threads.
+ *
+ * @param   count Number of replicas.
+ */
+void start_replicas(int count);
+
+/**
+ * @brief   Lets the replicas apply the remaining changes, stops them and
+ *          removes the change stream.
+ */
+void stop_replicas();
+
+/**
+ * @brief   Frees the replicas once their report has been printed.
+ */
+void destroy_replicas();
+
+/**
+ * @brief   Checks whether replication is in use.
+ *
+ * @return  1 if replicas have been started, 0 otherwise.
+ */
+int replicas_enabled();
+
+/**
+ * @brief   Publishes a committed write to the change stream.
+ *
+ * @details Must be called in write order by one writer at a time.
+ *
+ * @param   sum       Sum after the write.
+ * @param   writer_id ID of the writing thread.
+ */
+void replication_publish(int sum, int writer_id);
+
+/**
+ * @brief   Reads the sum from a replica without any locking.
+ *
+ * @param   reader_id ID of the reading thread, used to pick the replica.
+ *
+ * @return  The replica's copy of the sum.
+ */
+int replica_read(int reader_id);
+
+/**
+ * @brief   Prints how far each replica lagged behind the primary.
+ */
+void print_replica_report();
+
+#endif /* REPLICATION_H */
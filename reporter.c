@@ -0,0 +1,176 @@
+/**
+ * @file    reporter.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the live interval statistics reporter.
+ *
+ * @details Samples are taken with plain atomic loads of the per-thread
+ *          counters, the sum and the reader count, so reporting never
+ *          touches the data or reader semaphores. The values in a sample are
+ *          therefore not a consistent snapshot, which is fine for watching
+ *          trends. Sleeping uses a timed wait on a condition variable so
+ *          that stopping the reporter does not wait out an interval.
+ */
+
+#include "common.h"
+#include "utilities.h"
+#include "resources.h"
+#include "shared_data.h"
+#include "stats.h"
+#include "history.h"
+#include "reporter.h"
+
+#define NSEC_PER_MSEC 1000000L
+
+static pthread_t reporter_thread;
+static pthread_mutex_t reporter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t reporter_cond;  /* Waits on CLOCK_MONOTONIC */
+static int reporter_running = 0;
+static long report_interval_ms;
+static int report_json;
+
+/**
+ * @brief   Prints one interval sample.
+ *
+ * @details When the sum history is enabled, the range the sum moved
+ *          through during the interval is included.
+ * 
+ * @param   start   Monotonic time the reporter started.
+ * @param   from    Monotonic time the interval started.
+ * @param   to      Monotonic time the interval ended.
+ * @param   now     Counter totals at the end of the interval.
+ * @param   prev    Counter totals at the start of the interval.
+ */
+static void print_sample(long start, long from, long to,
+                         const StatsTotals* now, const StatsTotals* prev)
+{
+    double elapsed = (to - start) / (double)NSEC_PER_SEC;
+    double seconds = (to - from) / (double)NSEC_PER_SEC;
+    HistoryWindow window;
+    char range[MAX_STRING] = "";
+    double rate[NUM_FUNC];
+    unsigned long ops = 0;
+    int sum = __atomic_load_n(&get_shared_data()->sum, __ATOMIC_RELAXED);
+    int readers = __atomic_load_n(&get_resources()->readers_count,
+                                  __ATOMIC_RELAXED);
+    double wait_ms = (now->lock_wait_ns - prev->lock_wait_ns) /
+                     (double)NSEC_PER_MSEC;
+
+    for (int i = 0; i < NUM_FUNC; i++) {
+        rate[i] = (now->ops[i] - prev->ops[i]) / seconds;
+        ops += now->ops[i] - prev->ops[i];
+    }
+
+    if (history_window(from, to, &window) > 0) {
+        snprintf(range, sizeof(range), report_json ?
+                ",\"sum_min\":%d,\"sum_max\":%d" : " (%d..%d)",
+                window.min, window.max);
+    }
+
+    if (report_json) {
+        printf("{\"t\":%.3f,\"reads_per_s\":%.0f,\"incrs_per_s\":%.0f,"
+                "\"decrs_per_s\":%.0f,\"sum\":%d%s,\"readers\":%d,"
+                "\"lock_wait_ms\":%.3f}\n",
+                elapsed, rate[0], rate[1], rate[2], sum, range, readers,
+                wait_ms);
+    } else {
+        printf("[%8.3fs] reads %.0f/s incrs %.0f/s decrs %.0f/s "
+                "sum %d%s readers %d lock wait %.3f ms (%.2f us/op)\n",
+                elapsed, rate[0], rate[1], rate[2], sum, range, readers,
+                wait_ms, ops ? wait_ms * 1000.0 / ops : 0.0);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief   Reporter thread body.
+ *
+ * @param   arg Unused.
+ *
+ * @return  NULL
+ */
+static void* reporter(void* arg)
+{
+    StatsTotals prev, now;
+    struct timespec wake;
+    long start = monotonic_ns();
+    long last = start;
+
+    (void)arg;
+    stats_totals(&prev);
+    clock_gettime(CLOCK_MONOTONIC, &wake);
+
+    mutex_lock(&reporter_mutex);
+    while (reporter_running) {
+        /* Absolute wakeups keep the sampling period from drifting */
+        wake.tv_nsec += (report_interval_ms % 1000) * NSEC_PER_MSEC;
+        wake.tv_sec += report_interval_ms / 1000 +
+                       wake.tv_nsec / NSEC_PER_SEC;
+        wake.tv_nsec %= NSEC_PER_SEC;
+        while (reporter_running &&
+               pthread_cond_timedwait(&reporter_cond, &reporter_mutex,
+                                      &wake) == 0) {
+            /* Woken early without being stopped; keep waiting */
+        }
+        if (!reporter_running) {
+            break;
+        }
+
+        long t = monotonic_ns();
+        stats_totals(&now);
+        print_sample(start, last, t, &now, &prev);
+        prev = now;
+        last = t;
+    }
+    mutex_unlock(&reporter_mutex);
+    return NULL;
+}
+
+/**
+ * @brief   Starts the reporter thread.
+ *
+ * @param   interval_ms Sampling interval in milliseconds.
+ * @param   json        Print JSON lines instead of text.
+ */
+void start_reporter(long interval_ms, int json)
+{
+    pthread_condattr_t attr;
+
+    /* Wall clock steps must not stall or flood the periodic wakeups */
+    pthread_condattr_init(&attr);
+    if (pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) != 0 ||
+        pthread_cond_init(&reporter_cond, &attr) != 0) {
+        handle_error("Error initializing reporter condition variable");
+    }
+    pthread_condattr_destroy(&attr);
+
+    report_interval_ms = interval_ms;
+    report_json = json;
+    reporter_running = 1;
+    if (pthread_create(&reporter_thread, NULL, reporter, NULL) != 0) {
+        reporter_running = 0;
+        handle_error("Error creating reporter thread");
+    }
+}
+
+/**
+ * @brief   Stops the reporter thread and waits for it to exit.
+ */
+void stop_reporter()
+{
+    mutex_lock(&reporter_mutex);
+    if (!reporter_running) {
+        mutex_unlock(&reporter_mutex);
+        return;
+    }
+    reporter_running = 0;
+    pthread_cond_signal(&reporter_cond);
+    mutex_unlock(&reporter_mutex);
+
+    pthread_join(reporter_thread, NULL);
+    pthread_cond_destroy(&reporter_cond);
+}
+
+/* end reporter.c */
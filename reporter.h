@@ -0,0 +1,31 @@
+/**
+ * @file    reporter.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the live interval statistics reporter.
+ *
+ * @details A background thread that periodically samples the per-thread
+ *          counters and prints throughput by operation type, the current
+ *          sum, the active reader count and lock wait time for the last
+ *          interval, as text or as JSON lines.
+ */
+
+#ifndef REPORTER_H
+#define REPORTER_H
+
+/**
+ * @brief   Starts the reporter thread.
+ *
+ * @param   interval_ms Sampling interval in milliseconds.
+ * @param   json        Print JSON lines instead of text.
+ */
+void start_reporter(long interval_ms, int json);
+
+/**
+ * @brief   Stops the reporter thread and waits for it to exit.
+ */
+void stop_reporter();
+
+#endif /* REPORTER_H */
@@ -13,6 +13,7 @@
 #include "common.h"
 #include "resources.h"
 #include "utilities.h"
+#include "arg_parser.h"
 
 static Resources* resources = NULL;
 static pthread_mutex_t resource_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -34,8 +35,8 @@ Resources* init_resources()
         return resources;
     }
 
-    /* Allocate memory for the resources and handle potential errors */
-    resources = malloc(sizeof(Resources));
+    /* Allocate cache-aligned memory for the resources and handle errors */
+    resources = aligned_alloc(CACHE_LINE_SIZE, sizeof(Resources));
     if (!resources) {
         mutex_unlock(&resource_mutex);
         handle_error("Failed to allocate memory for resources struct");
@@ -45,6 +46,7 @@ Resources* init_resources()
     resources->threads = NULL;
     resources->readers_count = 0;
     resources->sem_initialised = 0;
+    configure_writer_lock();
 
     mutex_unlock(&resource_mutex);
 
@@ -70,7 +72,19 @@ Resources* get_resources()
 }
 
 /**
- * @brief   Allocates memory for the threads.
+ * @brief   Applies the writer lock options to the shared resources.
+ * 
+ * @details Lets the writer lock be changed between runs. Must only be called
+ *          while no threads are using the resources.
+ */
+void configure_writer_lock()
+{
+    resources->writer_lock = get_options()->writer_lock;
+    queue_lock_init(&resources->writer_queue, get_options()->backoff);
+}
+
+/**
+ * @brief   Allocates memory for the threads, replacing any earlier array.
  * 
  * @param   max_threads Number of threads to allocate.
  */
@@ -85,6 +99,7 @@ void alloc_threads(int max_threads)
     }
 
     /* Allocate memory for the thread pointers and handle errors */
+    free(resources->threads);
     resources->threads = (pthread_t *)malloc(max_threads * sizeof(pthread_t));
     if (resources->threads == NULL) {
         mutex_unlock(&resource_mutex);
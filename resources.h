@@ -14,6 +14,7 @@
 #define RESOURCES_H
 
 #include "common.h"
+#include "queue_lock.h"
 
 /**
  * @struct  Resources
@@ -22,6 +23,9 @@
  * 
  * @details Contains an array for threads, count of readers, semaphores for 
  *          data access and reader count, and a semaphore initialization flag.
+ *          Writers may additionally queue on an MCS lock before taking the
+ *          data semaphore, so that only one writer at a time contends with
+ *          the readers for it.
  */
 typedef struct {
     pthread_t* threads;
@@ -29,6 +33,8 @@ typedef struct {
     sem_t data_sem;
     sem_t reader_sem;
     int sem_initialised;
+    int writer_lock;            /* WRITER_LOCK_SEM or WRITER_LOCK_MCS */
+    QueueLock writer_queue;     /* FIFO queue of waiting writers      */
 } Resources;
 
 /**
@@ -46,7 +52,14 @@ Resources* init_resources();
 Resources* get_resources();
 
 /**
- * @brief   Allocates memory for the threads.
+ * @brief   Applies the writer lock options to the shared resources.
+ * 
+ * @details Must only be called while no threads are using the resources.
+ */
+void configure_writer_lock();
+
+/**
+ * @brief   Allocates memory for the threads, replacing any earlier array.
  * 
  * @param   max_threads Number of threads to allocate.
  */
@@ -0,0 +1,956 @@
+/**
+ * @file    schedule.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements lock event recording and the schedule simulator.
+ *
+ * @details Recording appends to a preallocated array through an atomic
+ *          index, so the order of the entries is the order in which the
+ *          threads reached each event. Events past the capacity are
+ *          counted but not kept.
+ *
+ *          The simulator models the semaphore protocol of
+ *          timed_read_operation() and timed_write_operation() as a small
+ *          state machine per thread. Each step is atomic, and a step that
+ *          would wait on a semaphore is not runnable until the semaphore is
+ *          posted. At every step the scheduler picks one runnable thread,
+ *          so the scheduler alone decides the interleaving.
+ */
+
+#include <errno.h>
+#include <stdatomic.h>
+#include "common.h"
+#include "utilities.h"
+#include "stats.h"
+#include "schedule.h"
+
+#define TRACE_LINE 64
+#define TRACE_MAX_THREADS 65536     /* Largest thread ID accepted, plus one */
+
+/**
+ * @struct  TraceEntry
+ *
+ * @brief   One recorded lock event.
+ */
+typedef struct {
+    long timestamp_ns;          /* When the event happened              */
+    int op;                     /* READ_OP, INCR_OP or DECR_OP          */
+    int id;                     /* ID among threads of the same type    */
+    LockEvent event;
+} TraceEntry;
+
+/* Next step of a simulated thread, following the semaphore protocol */
+enum {
+    PC_READER_LOCK_COUNT,       /* Wait for reader_sem to join          */
+    PC_READER_ENTER,            /* Increment the reader count           */
+    PC_READER_LOCK_DATA,        /* First reader waits for data_sem      */
+    PC_READER_UNLOCK_COUNT,     /* Post reader_sem; access granted      */
+    PC_READER_READ,             /* Read the sum                         */
+    PC_READER_LOCK_EXIT,        /* Wait for reader_sem to leave         */
+    PC_READER_LEAVE,            /* Last reader posts data_sem           */
+    PC_WRITER_LOCK_DATA,        /* Wait for data_sem; access granted    */
+    PC_WRITER_WRITE,            /* Modify the sum                       */
+    PC_WRITER_UNLOCK,           /* Post data_sem                        */
+    PC_DONE                     /* Every operation finished             */
+};
+
+/**
+ * @struct  SimThread
+ *
+ * @brief   State of one simulated thread.
+ */
+typedef struct {
+    int op;                     /* READ_OP, INCR_OP or DECR_OP          */
+    int pc;                     /* Next PC_* step                       */
+    int ops;                    /* Operations to perform                */
+    int ops_done;
+    long requested;             /* Step the current operation began at,
+                                 * or -1 while replay holds it back     */
+    const long* order;          /* Replay: trace index of each grant    */
+    const long* released;       /* Replay: grants recorded before each
+                                 * request                              */
+} SimThread;
+
+/**
+ * @struct  Simulation
+ *
+ * @brief   Simulated threads, semaphores and the waits they produced.
+ */
+typedef struct {
+    SimThread* threads;
+    int count;                  /* Number of threads                    */
+    int finished;               /* Threads that reached PC_DONE         */
+    int last;                   /* Thread scheduled last                */
+    int data_sem;               /* Values of the modelled semaphores    */
+    int reader_sem;
+    int readers_count;
+    long step;                  /* Steps taken so far                   */
+    unsigned int seed;          /* State of the random scheduler        */
+    long* reader_waits;         /* Steps from request to grant          */
+    long num_reader_waits;
+    long* writer_waits;
+    long num_writer_waits;
+    char* issued;               /* Replay: which recorded grants are done */
+    long num_grants;            /* Replay: number of recorded grants    */
+    long frontier;              /* Replay: recorded grants all done     */
+} Simulation;
+
+/**
+ * @struct  Scheduler
+ *
+ * @brief   Named policy choosing the next thread to step.
+ */
+typedef struct {
+    const char* name;
+    int (*pick)(Simulation* sim);
+} Scheduler;
+
+static TraceEntry* trace = NULL;
+static long trace_capacity = 0;
+static atomic_long trace_length = 0;
+
+static const char* const op_names[NUM_FUNC] = { "read", "incr", "decr" };
+static const char* const event_names[] = { "request", "acquire", "release" };
+
+/**
+ * @brief   Starts recording lock events.
+ *
+ * @param   capacity Maximum number of events to keep.
+ */
+void schedule_record_begin(long capacity)
+{
+    trace = malloc(capacity * sizeof(TraceEntry));
+    if (!trace) {
+        handle_error("Error allocating memory for lock trace");
+    }
+    trace_capacity = capacity;
+    atomic_store(&trace_length, 0);
+}
+
+/**
+ * @brief   Checks whether lock events are being recorded.
+ *
+ * @return  1 while recording, 0 otherwise.
+ */
+int schedule_recording()
+{
+    return trace != NULL;
+}
+
+/**
+ * @brief   Records a lock event of the calling thread, if recording.
+ *
+ * @param   op    Operation type: READ_OP, INCR_OP or DECR_OP.
+ * @param   id    ID of the thread among threads of its type.
+ * @param   event Event to record.
+ */
+void schedule_event(int op, int id, LockEvent event)
+{
+    if (!trace) {
+        return;
+    }
+    long index = atomic_fetch_add_explicit(&trace_length, 1,
+                                           memory_order_relaxed);
+    if (index < trace_capacity) {
+        trace[index].timestamp_ns = monotonic_ns();
+        trace[index].op = op;
+        trace[index].id = id;
+        trace[index].event = event;
+    }
+}
+
+/**
+ * @brief   Stops recording and saves the trace in the format read by
+ *          replay_schedule().
+ *
+ * @param   path Trace file to write.
+ */
+void schedule_record_end(const char* path)
+{
+    long length = atomic_load(&trace_length);
+    long kept = length < trace_capacity ? length : trace_capacity;
+    FILE* file = fopen(path, "w");
+
+    if (!file) {
+        char errorMsg[MAX_STRING * 2];
+        snprintf(errorMsg, sizeof(errorMsg), "Error creating trace %s: %s",
+                path, strerror(errno));
+        handle_error(errorMsg);
+    }
+    fprintf(file, "# a2 lock trace: op id event timestamp_ns\n");
+    for (long i = 0; i < kept; i++) {
+        fprintf(file, "%s %d %s %ld\n", op_names[OP_INDEX(trace[i].op)],
+                trace[i].id, event_names[trace[i].event],
+                trace[i].timestamp_ns);
+    }
+    if (fclose(file) != 0) {
+        handle_error("Error writing trace");
+    }
+    printf("Recorded %ld lock events to %s", kept, path);
+    if (length > kept) {
+        printf(" (%ld dropped)", length - kept);
+    }
+    printf("\n");
+
+    free(trace);
+    trace = NULL;
+}
+
+/**
+ * @brief   Looks a name up in a table of names.
+ *
+ * @param   name  Name to look up.
+ * @param   names Table of names.
+ * @param   count Number of names in the table.
+ *
+ * @return  Index of the name, or -1 if not recognised.
+ */
+static int find_name(const char* name, const char* const names[], int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief   Sets up a simulation of a thread mix.
+ *
+ * @details Incrementers come first, then decrementers, then readers.
+ *          Threads start with no operations; the caller sets `ops`.
+ *
+ * @param   sim              Simulation to set up.
+ * @param   num_incrementers Incrementer threads.
+ * @param   num_decrementers Decrementer threads.
+ * @param   num_readers      Reader threads.
+ */
+static void sim_init(Simulation* sim, int num_incrementers,
+                     int num_decrementers, int num_readers)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->count = num_incrementers + num_decrementers + num_readers;
+    sim->threads = calloc(sim->count, sizeof(SimThread));
+    if (!sim->threads) {
+        handle_error("Error allocating memory for schedule simulation");
+    }
+    for (int i = 0; i < sim->count; i++) {
+        sim->threads[i].op = i < num_incrementers ? INCR_OP
+                           : i < num_incrementers + num_decrementers ? DECR_OP
+                           : READ_OP;
+    }
+}
+
+/**
+ * @brief   Resets a simulation and allocates room for its waits.
+ *
+ * @param   sim  Simulation whose threads' operations are set.
+ * @param   seed Seed of the random scheduler.
+ */
+static void sim_reset(Simulation* sim, unsigned int seed)
+{
+    long reads = 0, writes = 0;
+
+    for (int i = 0; i < sim->count; i++) {
+        SimThread* th = &sim->threads[i];
+        th->pc = th->ops == 0 ? PC_DONE : th->op == READ_OP ?
+                 PC_READER_LOCK_COUNT : PC_WRITER_LOCK_DATA;
+        th->ops_done = 0;
+        th->requested = th->released ? -1 : 0;
+        *(th->op == READ_OP ? &reads : &writes) += th->ops;
+    }
+    sim->finished = 0;
+    for (int i = 0; i < sim->count; i++) {
+        sim->finished += sim->threads[i].pc == PC_DONE;
+    }
+    sim->last = sim->count - 1;
+    sim->data_sem = 1;
+    sim->reader_sem = 1;
+    sim->readers_count = 0;
+    sim->step = 0;
+    sim->seed = seed;
+    free(sim->reader_waits);
+    free(sim->writer_waits);
+    sim->reader_waits = malloc((reads + 1) * sizeof(long));
+    sim->writer_waits = malloc((writes + 1) * sizeof(long));
+    if (!sim->reader_waits || !sim->writer_waits) {
+        handle_error("Error allocating memory for schedule simulation");
+    }
+    sim->num_reader_waits = 0;
+    sim->num_writer_waits = 0;
+    if (sim->issued) {
+        memset(sim->issued, 0, sim->num_grants);
+    }
+    sim->frontier = 0;
+}
+
+/**
+ * @brief   Frees a simulation.
+ *
+ * @param   sim Simulation to free.
+ */
+static void sim_destroy(Simulation* sim)
+{
+    free(sim->threads);
+    free(sim->reader_waits);
+    free(sim->writer_waits);
+    free(sim->issued);
+}
+
+/**
+ * @brief   Checks whether a thread's next step can proceed.
+ *
+ * @param   sim Simulation.
+ * @param   t   Thread index.
+ *
+ * @return  1 if the step would not wait on a semaphore and replay is
+ *          not holding the thread back, 0 otherwise.
+ */
+static int runnable(const Simulation* sim, int t)
+{
+    if (sim->threads[t].requested < 0) {
+        return 0;
+    }
+    switch (sim->threads[t].pc) {
+    case PC_READER_LOCK_COUNT:
+    case PC_READER_LOCK_EXIT:
+        return sim->reader_sem > 0;
+    case PC_READER_LOCK_DATA:
+    case PC_WRITER_LOCK_DATA:
+        return sim->data_sem > 0;
+    case PC_DONE:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief   Finishes a thread's current operation and starts the next.
+ *
+ * @param   sim Simulation.
+ * @param   th  Thread that finished an operation.
+ */
+static void finish_operation(Simulation* sim, SimThread* th)
+{
+    if (++th->ops_done == th->ops) {
+        th->pc = PC_DONE;
+        sim->finished++;
+    } else {
+        th->pc = th->op == READ_OP ? PC_READER_LOCK_COUNT
+                                   : PC_WRITER_LOCK_DATA;
+        th->requested = th->released ? -1 : sim->step + 1;
+    }
+}
+
+/**
+ * @brief   Records that a thread was granted access to the shared data.
+ *
+ * @details In replay, also advances the frontier past every recorded grant
+ *          that has now been issued.
+ *
+ * @param   sim Simulation.
+ * @param   th  Thread granted access.
+ */
+static void grant_access(Simulation* sim, SimThread* th)
+{
+    long wait = sim->step - th->requested;
+
+    if (th->op == READ_OP) {
+        sim->reader_waits[sim->num_reader_waits++] = wait;
+    } else {
+        sim->writer_waits[sim->num_writer_waits++] = wait;
+    }
+    if (sim->issued) {
+        sim->issued[th->order[th->ops_done]] = 1;
+        while (sim->frontier < sim->num_grants &&
+               sim->issued[sim->frontier]) {
+            sim->frontier++;
+        }
+    }
+}
+
+/**
+ * @brief   Lets replayed threads make their next request once every grant
+ *          recorded before that request has been issued, and starts their
+ *          wait clock there.
+ *
+ * @param   sim Simulation.
+ */
+static void release_requests(Simulation* sim)
+{
+    if (!sim->issued) {
+        return;
+    }
+    for (int t = 0; t < sim->count; t++) {
+        SimThread* th = &sim->threads[t];
+        if (th->pc != PC_DONE && th->requested < 0 &&
+            th->released[th->ops_done] <= sim->frontier) {
+            th->requested = sim->step;
+        }
+    }
+}
+
+/**
+ * @brief   Takes one step of a runnable thread.
+ *
+ * @param   sim Simulation.
+ * @param   t   Thread index.
+ */
+static void step_thread(Simulation* sim, int t)
+{
+    SimThread* th = &sim->threads[t];
+
+    switch (th->pc) {
+    case PC_READER_LOCK_COUNT:
+        sim->reader_sem--;
+        th->pc = PC_READER_ENTER;
+        break;
+    case PC_READER_ENTER:
+        th->pc = ++sim->readers_count == 1 ? PC_READER_LOCK_DATA
+                                           : PC_READER_UNLOCK_COUNT;
+        break;
+    case PC_READER_LOCK_DATA:
+        sim->data_sem--;
+        th->pc = PC_READER_UNLOCK_COUNT;
+        break;
+    case PC_READER_UNLOCK_COUNT:
+        sim->reader_sem++;
+        grant_access(sim, th);
+        th->pc = PC_READER_READ;
+        break;
+    case PC_READER_READ:
+        th->pc = PC_READER_LOCK_EXIT;
+        break;
+    case PC_READER_LOCK_EXIT:
+        sim->reader_sem--;
+        th->pc = PC_READER_LEAVE;
+        break;
+    case PC_READER_LEAVE:
+        if (--sim->readers_count == 0) {
+            sim->data_sem++;
+        }
+        sim->reader_sem++;
+        finish_operation(sim, th);
+        break;
+    case PC_WRITER_LOCK_DATA:
+        sim->data_sem--;
+        grant_access(sim, th);
+        th->pc = PC_WRITER_WRITE;
+        break;
+    case PC_WRITER_WRITE:
+        th->pc = PC_WRITER_UNLOCK;
+        break;
+    case PC_WRITER_UNLOCK:
+        sim->data_sem++;
+        finish_operation(sim, th);
+        break;
+    }
+    sim->step++;
+    sim->last = t;
+}
+
+/**
+ * @brief   Picks the runnable thread with the lowest rank, breaking ties
+ *          round-robin from the thread scheduled last.
+ *
+ * @param   sim  Simulation.
+ * @param   rank Ranks a thread; lower runs first.
+ *
+ * @return  Thread index, or -1 if no thread is runnable.
+ */
+static int pick_ranked(Simulation* sim,
+                       long (*rank)(const Simulation* sim, int t))
+{
+    int best = -1;
+    long best_rank = 0;
+
+    for (int k = 1; k <= sim->count; k++) {
+        int t = (sim->last + k) % sim->count;
+        if (runnable(sim, t)) {
+            long r = rank(sim, t);
+            if (best < 0 || r < best_rank) {
+                best = t;
+                best_rank = r;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief   Ranks every thread the same, for round-robin scheduling.
+ *
+ * @param   sim Simulation.
+ * @param   t   Thread index.
+ *
+ * @return  0
+ */
+static long rank_fair(const Simulation* sim, int t)
+{
+    (void)sim;
+    (void)t;
+    return 0;
+}
+
+/**
+ * @brief   Ranks entering readers first and writers last, so that readers
+ *          always overlap and the data semaphore is never free for writers
+ *          while any reader has work left.
+ *
+ * @param   sim Simulation.
+ * @param   t   Thread index.
+ *
+ * @return  0 for entering readers, 1 for other readers, 2 for writers.
+ */
+static long rank_reader_overlap(const Simulation* sim, int t)
+{
+    const SimThread* th = &sim->threads[t];
+
+    if (th->op != READ_OP) {
+        return 2;
+    }
+    return th->pc <= PC_READER_UNLOCK_COUNT ? 0 : 1;
+}
+
+/**
+ * @brief   Ranks threads holding the shared data last, as if the holder
+ *          were always preempted, so that everyone else queues behind it.
+ *
+ * @param   sim Simulation.
+ * @param   t   Thread index.
+ *
+ * @return  1 for a thread inside the shared data, 0 otherwise.
+ */
+static long rank_convoy(const Simulation* sim, int t)
+{
+    int pc = sim->threads[t].pc;
+
+    return (pc >= PC_READER_READ && pc <= PC_READER_LEAVE) ||
+           pc == PC_WRITER_WRITE || pc == PC_WRITER_UNLOCK;
+}
+
+/**
+ * @brief   Ranks threads by the trace position of their next grant, so
+ *          that access is granted in the recorded order where possible.
+ *
+ * @param   sim Simulation.
+ * @param   t   Thread index.
+ *
+ * @return  Index of the thread's next grant in the recorded order.
+ */
+static long rank_replay(const Simulation* sim, int t)
+{
+    const SimThread* th = &sim->threads[t];
+
+    return th->order[th->ops_done];
+}
+
+/**
+ * @brief   Picks runnable threads round-robin.
+ *
+ * @param   sim Simulation.
+ *
+ * @return  Thread index, or -1 if no thread is runnable.
+ */
+static int pick_fair(Simulation* sim)
+{
+    return pick_ranked(sim, rank_fair);
+}
+
+/**
+ * @brief   Picks threads so that readers continuously overlap.
+ *
+ * @param   sim Simulation.
+ *
+ * @return  Thread index, or -1 if no thread is runnable.
+ */
+static int pick_reader_overlap(Simulation* sim)
+{
+    return pick_ranked(sim, rank_reader_overlap);
+}
+
+/**
+ * @brief   Picks threads so that the holder of the shared data only runs
+ *          when nobody else can.
+ *
+ * @param   sim Simulation.
+ *
+ * @return  Thread index, or -1 if no thread is runnable.
+ */
+static int pick_convoy(Simulation* sim)
+{
+    return pick_ranked(sim, rank_convoy);
+}
+
+/**
+ * @brief   Picks threads in the recorded order of grants.
+ *
+ * @param   sim Simulation with replay orders.
+ *
+ * @return  Thread index, or -1 if no thread is runnable.
+ */
+static int pick_replay(Simulation* sim)
+{
+    return pick_ranked(sim, rank_replay);
+}
+
+/**
+ * @brief   Picks a runnable thread uniformly at random.
+ *
+ * @param   sim Simulation, whose seed advances.
+ *
+ * @return  Thread index, or -1 if no thread is runnable.
+ */
+static int pick_random(Simulation* sim)
+{
+    int choices = 0, chosen;
+
+    for (int t = 0; t < sim->count; t++) {
+        choices += runnable(sim, t);
+    }
+    if (choices == 0) {
+        return -1;
+    }
+    chosen = rand_r(&sim->seed) % choices;
+    for (int t = 0; t < sim->count; t++) {
+        if (runnable(sim, t) && chosen-- == 0) {
+            return t;
+        }
+    }
+    return -1;
+}
+
+static const Scheduler schedulers[] = {
+    { "fair", pick_fair },
+    { "random", pick_random },
+    { "reader-overlap", pick_reader_overlap },
+    { "convoy", pick_convoy }
+};
+
+#define NUM_SCHEDULERS (int)(sizeof(schedulers) / sizeof(*schedulers))
+
+/**
+ * @brief   Runs a simulation until every thread has finished.
+ *
+ * @param   sim  Simulation, reset beforehand.
+ * @param   pick Scheduler choosing each step.
+ */
+static void sim_run(Simulation* sim, int (*pick)(Simulation* sim))
+{
+    while (sim->finished < sim->count) {
+        release_requests(sim);
+        int t = pick(sim);
+        if (t < 0) {
+            handle_error("Schedule simulation deadlocked");
+        }
+        step_thread(sim, t);
+    }
+}
+
+/**
+ * @brief   Orders waits for qsort().
+ *
+ * @param   a First wait.
+ * @param   b Second wait.
+ *
+ * @return  Negative, zero or positive as a is less, equal or greater.
+ */
+static int compare_wait(const void* a, const void* b)
+{
+    long x = *(const long*)a, y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief   Prints the mean, tail and maximum of a set of waits.
+ *
+ * @param   waits Waits, sorted in place.
+ * @param   count Number of waits.
+ * @param   scale Units per wait, to convert for display.
+ */
+static void print_waits(long* waits, long count, double scale)
+{
+    double total = 0.0;
+
+    if (count == 0) {
+        printf(" %10s %9s %9s", "-", "-", "-");
+        return;
+    }
+    qsort(waits, count, sizeof(long), compare_wait);
+    for (long i = 0; i < count; i++) {
+        total += waits[i];
+    }
+    printf(" %10.1f %9.1f %9.1f", total / count * scale,
+            waits[(long)(TAIL_PERCENTILE / 100.0 * (count - 1))] * scale,
+            waits[count - 1] * scale);
+}
+
+/**
+ * @brief   Prints the heading of a wait time table.
+ *
+ * @param   units Units of the waits.
+ */
+static void print_heading(const char* units)
+{
+    char tail[MAX_STRING];
+
+    snprintf(tail, sizeof(tail), "p%g", TAIL_PERCENTILE);
+    printf("%-16s %9s %-30s %s\n", "", "", "      reader wait",
+            "      writer wait");
+    printf("%-16s %9s %10s %9s %9s %10s %9s %9s  (%s)\n", "scenario",
+            "steps", "mean", tail, "max", "mean", tail, "max", units);
+}
+
+/**
+ * @brief   Prints the waits of a finished simulation as a table row.
+ *
+ * @param   name Scenario name.
+ * @param   sim  Finished simulation.
+ */
+static void print_simulation(const char* name, Simulation* sim)
+{
+    printf("%-16s %9ld", name, sim->step);
+    print_waits(sim->reader_waits, sim->num_reader_waits, 1.0);
+    print_waits(sim->writer_waits, sim->num_writer_waits, 1.0);
+    printf("\n");
+}
+
+/**
+ * @brief   Simulates a thread mix under one or every built-in scheduler
+ *          and reports the wait times of each.
+ *
+ * @param   scenario         Scheduler name, or "all".
+ * @param   num_incrementers Incrementer threads to simulate.
+ * @param   num_decrementers Decrementer threads to simulate.
+ * @param   num_readers      Reader threads to simulate.
+ * @param   ops_per_thread   Operations each thread performs.
+ * @param   seed             Seed of the random scheduler.
+ */
+void simulate_schedules(const char* scenario, int num_incrementers,
+                        int num_decrementers, int num_readers,
+                        int ops_per_thread, long seed)
+{
+    Simulation sim;
+    int only = -1;
+
+    if (strcmp(scenario, "all") != 0) {
+        for (int s = 0; s < NUM_SCHEDULERS; s++) {
+            if (strcmp(scenario, schedulers[s].name) == 0) {
+                only = s;
+            }
+        }
+        if (only < 0) {
+            handle_error("Unknown schedule scenario.\n"
+                         "Use fair, random, reader-overlap, convoy or all.");
+        }
+    }
+
+    sim_init(&sim, num_incrementers, num_decrementers, num_readers);
+    for (int i = 0; i < sim.count; i++) {
+        sim.threads[i].ops = ops_per_thread;
+    }
+    printf("Simulating %d incrementers, %d decrementers and %d readers, "
+            "%d operations each, seed %ld\n", num_incrementers,
+            num_decrementers, num_readers, ops_per_thread, seed);
+    print_heading("steps");
+    for (int s = 0; s < NUM_SCHEDULERS; s++) {
+        if (only < 0 || only == s) {
+            sim_reset(&sim, (unsigned int)seed);
+            sim_run(&sim, schedulers[s].pick);
+            print_simulation(schedulers[s].name, &sim);
+        }
+    }
+    sim_destroy(&sim);
+}
+
+/**
+ * @brief   Reads a recorded trace.
+ *
+ * @param   path   Trace file written by schedule_record_end().
+ * @param   length Receives the number of entries.
+ *
+ * @return  The entries, to be freed by the caller.
+ */
+static TraceEntry* load_trace(const char* path, long* length)
+{
+    char line[TRACE_LINE], op[TRACE_LINE], event[TRACE_LINE];
+    char errorMsg[MAX_STRING * 2];
+    long capacity = 1024, line_number = 0;
+    TraceEntry* entries = malloc(capacity * sizeof(TraceEntry));
+    FILE* file = fopen(path, "r");
+
+    if (!file) {
+        snprintf(errorMsg, sizeof(errorMsg), "Error opening trace %s: %s",
+                path, strerror(errno));
+        handle_error(errorMsg);
+    }
+    *length = 0;
+    while (entries && fgets(line, sizeof(line), file)) {
+        TraceEntry* entry;
+        line_number++;
+        if (line[0] == '#') {
+            continue;
+        }
+        if (*length == capacity) {
+            capacity *= 2;
+            TraceEntry* grown = realloc(entries,
+                                        capacity * sizeof(TraceEntry));
+            if (!grown) {
+                free(entries);
+                entries = NULL;
+                break;
+            }
+            entries = grown;
+        }
+        entry = &entries[*length];
+        int op_index = -1, event_index = -1;
+        if (sscanf(line, "%63s %d %63s %ld", op, &entry->id, event,
+                   &entry->timestamp_ns) != 4 ||
+            (op_index = find_name(op, op_names, NUM_FUNC)) < 0 ||
+            (event_index = find_name(event, event_names, 3)) < 0 ||
+            entry->id < 0 || entry->id >= TRACE_MAX_THREADS) {
+            fclose(file);
+            free(entries);
+            snprintf(errorMsg, sizeof(errorMsg),
+                    "Invalid event on line %ld of trace %s",
+                    line_number, path);
+            handle_error(errorMsg);
+        }
+        entry->op = op_index == 0 ? READ_OP : op_index == 1 ? INCR_OP
+                                                            : DECR_OP;
+        entry->event = (LockEvent)event_index;
+        (*length)++;
+    }
+    fclose(file);
+    if (!entries) {
+        handle_error("Error allocating memory for trace");
+    }
+    return entries;
+}
+
+/**
+ * @brief   Replays the acquisition order of a recorded trace and reports
+ *          the recorded and simulated wait times.
+ *
+ * @details Each thread performs as many operations as it was granted
+ *          access in the trace. Operations that never acquired the lock,
+ *          such as timed out or eliminated ones, are left out. A thread
+ *          only makes each request once the replay has issued every grant
+ *          recorded before it, so time the real thread spent not asking
+ *          for the lock is not counted as waiting.
+ *
+ * @param   path Trace file written by schedule_record_end().
+ */
+void replay_schedule(const char* path)
+{
+    int num_threads[NUM_FUNC] = { 0, 0, 0 };
+    long length, acquisitions = 0;
+    Simulation sim;
+    TraceEntry* entries = load_trace(path, &length);
+
+    /* Size the thread mix from the highest ID of each type */
+    for (long i = 0; i < length; i++) {
+        int* count = &num_threads[OP_INDEX(entries[i].op)];
+        if (entries[i].id >= *count) {
+            *count = entries[i].id + 1;
+        }
+    }
+    int first[NUM_FUNC] = {
+        num_threads[OP_INDEX(INCR_OP)] + num_threads[OP_INDEX(DECR_OP)],
+        0,
+        num_threads[OP_INDEX(INCR_OP)]
+    };
+    sim_init(&sim, num_threads[OP_INDEX(INCR_OP)],
+             num_threads[OP_INDEX(DECR_OP)], num_threads[OP_INDEX(READ_OP)]);
+
+    /* Pair requests with grants for the recorded waits */
+    long* requested = malloc(sim.count * sizeof(long));
+    long* real_waits[2] = { malloc((length + 1) * sizeof(long)),
+                            malloc((length + 1) * sizeof(long)) };
+    long num_real_waits[2] = { 0, 0 };
+    if (!requested || !real_waits[0] || !real_waits[1]) {
+        handle_error("Error allocating memory for trace replay");
+    }
+    for (int t = 0; t < sim.count; t++) {
+        requested[t] = -1;
+    }
+    for (long i = 0; i < length; i++) {
+        int t = first[OP_INDEX(entries[i].op)] + entries[i].id;
+        int writer = entries[i].op != READ_OP;
+        if (entries[i].event == SCHED_REQUEST) {
+            requested[t] = entries[i].timestamp_ns;
+        } else if (entries[i].event == SCHED_ACQUIRE) {
+            sim.threads[t].ops++;
+            acquisitions++;
+            if (requested[t] >= 0) {
+                real_waits[writer][num_real_waits[writer]++] =
+                    entries[i].timestamp_ns - requested[t];
+                requested[t] = -1;
+            }
+        }
+    }
+
+    if (acquisitions == 0) {
+        handle_error("Trace has no lock grants to replay");
+    }
+
+    /* Give every thread the index of each of its grants in the recorded
+     * order, and the number of grants recorded before each request */
+    long* order = malloc(acquisitions * sizeof(long));
+    long* released = malloc(acquisitions * sizeof(long));
+    sim.issued = malloc(acquisitions);
+    if (!order || !released || !sim.issued) {
+        handle_error("Error allocating memory for trace replay");
+    }
+    sim.num_grants = acquisitions;
+    long offset = 0;
+    for (int t = 0; t < sim.count; t++) {
+        sim.threads[t].order = order + offset;
+        sim.threads[t].released = released + offset;
+        offset += sim.threads[t].ops;
+        sim.threads[t].ops = 0;
+        requested[t] = -1;
+    }
+    long grants = 0;
+    for (long i = 0; i < length; i++) {
+        int t = first[OP_INDEX(entries[i].op)] + entries[i].id;
+        SimThread* th = &sim.threads[t];
+        if (entries[i].event == SCHED_REQUEST) {
+            requested[t] = grants;
+        } else if (entries[i].event == SCHED_ACQUIRE) {
+            order[th->order - order + th->ops] = grants;
+            released[th->order - order + th->ops] =
+                requested[t] >= 0 ? requested[t] : grants;
+            th->ops++;
+            requested[t] = -1;
+            grants++;
+        }
+    }
+
+    printf("Replaying %ld grants to %d incrementers, %d decrementers and "
+            "%d readers from %s\n", acquisitions,
+            num_threads[OP_INDEX(INCR_OP)], num_threads[OP_INDEX(DECR_OP)],
+            num_threads[OP_INDEX(READ_OP)], path);
+    print_heading("recorded in us, replayed in steps");
+    printf("%-16s %9s", "recorded", "-");
+    print_waits(real_waits[0], num_real_waits[0], 1.0 / NSEC_PER_USEC);
+    print_waits(real_waits[1], num_real_waits[1], 1.0 / NSEC_PER_USEC);
+    printf("\n");
+    sim_reset(&sim, 0);
+    sim_run(&sim, pick_replay);
+    print_simulation("replay", &sim);
+
+    free(order);
+    free(released);
+    free(real_waits[0]);
+    free(real_waits[1]);
+    free(requested);
+    free(entries);
+    sim_destroy(&sim);
+}
+
+/* end schedule.c */
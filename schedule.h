@@ -0,0 +1,95 @@
+/**
+ * @file    schedule.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares lock event recording and the schedule simulator.
+ *
+ * @details A normal run can record the order in which operations request,
+ *          acquire and release access to the shared data. The simulator
+ *          replays the semaphore readers-writers protocol one step at a
+ *          time under a chosen scheduler: either the acquisition order of
+ *          a recorded trace, a fair or seeded random choice, or an
+ *          adversary that steers the protocol into a known pathology. Every
+ *          run is deterministic, so a latency outlier seen once can be
+ *          reproduced on demand. Simulated waits are counted in protocol
+ *          steps rather than time.
+ */
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#define SCHED_TRACE_CAPACITY (1L << 20) /* Lock events kept per recording */
+
+/**
+ * @enum    LockEvent
+ *
+ * @brief   Point in an operation's use of the shared data lock.
+ */
+typedef enum {
+    SCHED_REQUEST,          /* Operation started                           */
+    SCHED_ACQUIRE,          /* Access to the shared data granted           */
+    SCHED_RELEASE           /* Access to the shared data given up          */
+} LockEvent;
+
+/**
+ * @brief   Starts recording lock events.
+ *
+ * @param   capacity Maximum number of events to keep.
+ */
+void schedule_record_begin(long capacity);
+
+/**
+ * @brief   Checks whether lock events are being recorded.
+ *
+ * @return  1 while recording, 0 otherwise.
+ */
+int schedule_recording();
+
+/**
+ * @brief   Records a lock event of the calling thread, if recording.
+ *
+ * @param   op    Operation type: READ_OP, INCR_OP or DECR_OP.
+ * @param   id    ID of the thread among threads of its type.
+ * @param   event Event to record.
+ */
+void schedule_event(int op, int id, LockEvent event);
+
+/**
+ * @brief   Stops recording and saves the trace in the format read by
+ *          replay_schedule().
+ *
+ * @param   path Trace file to write.
+ */
+void schedule_record_end(const char* path);
+
+/**
+ * @brief   Simulates a thread mix under one or every built-in scheduler
+ *          and reports the wait times of each.
+ *
+ * @details The schedulers are fair (round-robin), random (seeded),
+ *          reader-overlap (keeps a reader inside at all times, starving
+ *          writers) and convoy (preempts whoever holds the data, so others
+ *          pile up behind it).
+ *
+ * @param   scenario         Scheduler name, or "all".
+ * @param   num_incrementers Incrementer threads to simulate.
+ * @param   num_decrementers Decrementer threads to simulate.
+ * @param   num_readers      Reader threads to simulate.
+ * @param   ops_per_thread   Operations each thread performs.
+ * @param   seed             Seed of the random scheduler.
+ */
+void simulate_schedules(const char* scenario, int num_incrementers,
+                        int num_decrementers, int num_readers,
+                        int ops_per_thread, long seed);
+
+/**
+ * @brief   Replays the acquisition order of a recorded trace and reports
+ *          the recorded and simulated wait times.
+ *
+ * @param   path Trace file written by schedule_record_end().
+ */
+void replay_schedule(const char* path);
+
+#endif /* SCHEDULE_H */
@@ -0,0 +1,390 @@
+/**
+ * @file    server.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the Unix domain socket counter server.
+ *
+ * @details A single thread multiplexes the listening socket, a signalfd and
+ *          every client connection through level-triggered epoll. For each
+ *          wakeup it first drains and applies all readable requests, then
+ *          makes the writes durable with one wal_sync(), and only then
+ *          writes the buffered responses, so pipelined requests from many
+ *          clients share a single group commit.
+ */
+
+#define _GNU_SOURCE             /* accept4() */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "common.h"
+#include "utilities.h"
+#include "protocol.h"
+#include "thread_operations.h"
+#include "wal.h"
+#include "server.h"
+
+/**
+ * @struct  Connection
+ *
+ * @brief   Buffered state of one client connection.
+ */
+typedef struct Connection {
+    struct Connection* prev;    /* Neighbours in the open connection list */
+    struct Connection* next;
+    int fd;                     /* Client socket                         */
+    int id;                     /* Writer ID used for this client        */
+    int dirty;                  /* Has responses queued this wakeup      */
+    uint32_t events;            /* Events currently registered           */
+    size_t in_len;              /* Bytes of pending requests             */
+    size_t out_len;             /* Bytes of unsent responses             */
+    char in[SERVER_BUFFER];
+    char out[SERVER_BUFFER];
+} Connection;
+
+static int epoll_fd = -1;
+static Connection* open_connections = NULL;
+static char listener_tag;       /* epoll data for the listening socket   */
+static char signal_tag;         /* epoll data for the signalfd           */
+static unsigned long requests_served = 0;
+static unsigned long connections_accepted = 0;
+
+/**
+ * @brief   Reports a failed system call in the server and exits.
+ *
+ * @param   what Description of the failed operation.
+ */
+static void server_error(const char* what)
+{
+    char errorMsg[MAX_STRING];
+    snprintf(errorMsg, sizeof(errorMsg), "Server: %s: %s",
+            what, strerror(errno));
+    handle_error(errorMsg);
+}
+
+/**
+ * @brief   Registers or updates the events a connection is polled for.
+ *
+ * @details Input is only polled while there is room to buffer it, and
+ *          output only while responses are waiting to be sent, so a slow
+ *          reader applies backpressure to its own requests.
+ *
+ * @param   conn Connection to update.
+ * @param   op   EPOLL_CTL_ADD or EPOLL_CTL_MOD.
+ */
+static void watch_connection(Connection* conn, int op)
+{
+    struct epoll_event ev = { .data.ptr = conn };
+
+    ev.events = (conn->in_len < SERVER_BUFFER ? EPOLLIN : 0) |
+                (conn->out_len ? EPOLLOUT : 0);
+    if (op == EPOLL_CTL_MOD && ev.events == conn->events) {
+        return;
+    }
+    if (epoll_ctl(epoll_fd, op, conn->fd, &ev) != 0) {
+        server_error("registering connection");
+    }
+    conn->events = ev.events;
+}
+
+/**
+ * @brief   Closes a connection and frees its buffers.
+ *
+ * @param   conn Connection to close.
+ */
+static void close_connection(Connection* conn)
+{
+    if (conn->prev) {
+        conn->prev->next = conn->next;
+    } else {
+        open_connections = conn->next;
+    }
+    if (conn->next) {
+        conn->next->prev = conn->prev;
+    }
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn);
+}
+
+/**
+ * @brief   Accepts every pending connection on the listening socket.
+ *
+ * @param   listen_fd Listening socket.
+ */
+static void accept_connections(int listen_fd)
+{
+    int fd;
+
+    while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+        Connection* conn = calloc(1, sizeof(Connection));
+        if (!conn) {
+            close(fd);
+            handle_error("Error allocating memory for connection");
+        }
+        conn->fd = fd;
+        conn->id = (int)connections_accepted++;
+        conn->next = open_connections;
+        if (open_connections) {
+            open_connections->prev = conn;
+        }
+        open_connections = conn;
+        watch_connection(conn, EPOLL_CTL_ADD);
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        server_error("accepting connection");
+    }
+}
+
+/**
+ * @brief   Applies buffered requests while there is room for responses.
+ *
+ * @param   conn Connection whose requests to apply.
+ *
+ * @return  0 on success, -1 if the client sent an invalid request.
+ */
+static int apply_requests(Connection* conn)
+{
+    size_t used = 0;
+
+    while (conn->in_len - used >= sizeof(Request) &&
+           SERVER_BUFFER - conn->out_len >= sizeof(Response)) {
+        Request req;
+        Response resp;
+        memcpy(&req, conn->in + used, sizeof(req));
+
+        /* Keep the reserved field free for later protocol extensions */
+        if (req.reserved != 0) {
+            return -1;
+        }
+        switch (req.op) {
+        case PROTO_READ:
+            resp.value = read_operation(conn->id);
+            break;
+        case PROTO_INCR:
+            resp.value = write_operation(INCR_OP, conn->id);
+            break;
+        case PROTO_DECR:
+            resp.value = write_operation(DECR_OP, conn->id);
+            break;
+        default:
+            return -1;
+        }
+        resp.tag = req.tag;
+        memcpy(conn->out + conn->out_len, &resp, sizeof(resp));
+        conn->out_len += sizeof(resp);
+        used += sizeof(req);
+        requests_served++;
+    }
+
+    memmove(conn->in, conn->in + used, conn->in_len - used);
+    conn->in_len -= used;
+    conn->dirty = conn->out_len > 0;
+    return 0;
+}
+
+/**
+ * @brief   Reads what the client has sent and applies complete requests.
+ *
+ * @param   conn Readable connection.
+ *
+ * @return  0 on success, -1 if the connection should be closed.
+ */
+static int read_requests(Connection* conn)
+{
+    if (conn->in_len == SERVER_BUFFER) {
+        return apply_requests(conn);
+    }
+    ssize_t n = read(conn->fd, conn->in + conn->in_len,
+                     SERVER_BUFFER - conn->in_len);
+
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        return -1;
+    }
+    if (n > 0) {
+        conn->in_len += n;
+    }
+    return apply_requests(conn);
+}
+
+/**
+ * @brief   Writes as many buffered responses as the socket accepts.
+ *
+ * @param   conn Connection to flush.
+ *
+ * @return  0 on success, -1 if the connection should be closed.
+ */
+static int write_responses(Connection* conn)
+{
+    ssize_t n = send(conn->fd, conn->out, conn->out_len, MSG_NOSIGNAL);
+
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+    memmove(conn->out, conn->out + n, conn->out_len - n);
+    conn->out_len -= n;
+    return 0;
+}
+
+/**
+ * @brief   Creates, binds and registers the listening socket.
+ *
+ * @param   socket_path Filesystem path to listen on.
+ *
+ * @return  The listening socket.
+ */
+static int open_listener(const char* socket_path)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &listener_tag };
+
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        handle_error("Server: socket path too long");
+    }
+    strcpy(addr.sun_path, socket_path);
+    unlink(socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        server_error("creating socket");
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        server_error(socket_path);
+    }
+    if (listen(fd, SOMAXCONN) != 0) {
+        server_error("listening");
+    }
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        server_error("registering listener");
+    }
+    return fd;
+}
+
+/**
+ * @brief   Routes SIGINT and SIGTERM to a signalfd watched by epoll.
+ *
+ * @return  The signalfd.
+ */
+static int open_signals()
+{
+    sigset_t mask;
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &signal_tag };
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &mask, NULL) != 0) {
+        handle_error("Server: blocking signals");
+    }
+    int fd = signalfd(-1, &mask, SFD_NONBLOCK);
+    if (fd < 0) {
+        server_error("creating signalfd");
+    }
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        server_error("registering signalfd");
+    }
+    return fd;
+}
+
+/**
+ * @brief   Sends the responses produced during one wakeup.
+ *
+ * @details Makes every write applied during the wakeup durable first, so a
+ *          response is never sent for a change that could still be lost.
+ *
+ * @param   dirty Connections with queued responses.
+ * @param   count Number of dirty connections.
+ */
+static void flush_dirty(Connection* dirty[], int count)
+{
+    wal_sync();
+
+    for (int i = 0; i < count; i++) {
+        Connection* conn = dirty[i];
+        conn->dirty = 0;
+        if (write_responses(conn) != 0) {
+            close_connection(conn);
+        } else {
+            watch_connection(conn, EPOLL_CTL_MOD);
+        }
+    }
+}
+
+/**
+ * @brief   Serves the shared counter until SIGINT or SIGTERM.
+ *
+ * @param   socket_path Filesystem path to listen on.
+ */
+void run_server(const char* socket_path)
+{
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    Connection* dirty[SERVER_MAX_EVENTS];
+    int running = 1;
+
+    if ((epoll_fd = epoll_create1(0)) < 0) {
+        server_error("creating epoll instance");
+    }
+    int signal_fd = open_signals();
+    int listen_fd = open_listener(socket_path);
+
+    while (running) {
+        int n = epoll_wait(epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        int num_dirty = 0;
+        if (n < 0 && errno != EINTR) {
+            server_error("waiting for events");
+        }
+
+        for (int i = 0; i < n; i++) {
+            void* tag = events[i].data.ptr;
+            if (tag == &signal_tag) {
+                running = 0;
+            } else if (tag == &listener_tag) {
+                accept_connections(listen_fd);
+            } else {
+                Connection* conn = tag;
+                int status = 0;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    status = read_requests(conn);
+                } else if (events[i].events & EPOLLOUT) {
+                    status = write_responses(conn) || apply_requests(conn);
+                }
+                if (status != 0) {
+                    close_connection(conn);
+                } else if (conn->dirty) {
+                    dirty[num_dirty++] = conn;
+                } else {
+                    watch_connection(conn, EPOLL_CTL_MOD);
+                }
+            }
+        }
+        flush_dirty(dirty, num_dirty);
+    }
+
+    while (open_connections) {
+        close_connection(open_connections);
+    }
+    close(listen_fd);
+    close(signal_fd);
+    close(epoll_fd);
+    unlink(socket_path);
+}
+
+/**
+ * @brief   Retrieves server statistics.
+ *
+ * @param   requests    Receives the number of requests served.
+ * @param   connections Receives the number of connections accepted.
+ */
+void server_stats(unsigned long* requests, unsigned long* connections)
+{
+    *requests = requests_served;
+    *connections = connections_accepted;
+}
+
+/* end server.c */
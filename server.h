@@ -0,0 +1,39 @@
+/**
+ * @file    server.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the Unix domain socket counter server.
+ *
+ * @details In server mode the shared counter is served to other local
+ *          processes over the protocol in protocol.h, using the same
+ *          readers and writers protocol as the program's own threads.
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#define SERVER_BUFFER 16384     /* Per-connection input/output buffer   */
+#define SERVER_MAX_EVENTS 64    /* Events handled per epoll_wait()      */
+
+/**
+ * @brief   Serves the shared counter until SIGINT or SIGTERM.
+ *
+ * @details Runs a single-threaded epoll event loop. All requests that
+ *          arrive in one wakeup are applied, then committed to the log
+ *          together, before their responses are written back.
+ *
+ * @param   socket_path Filesystem path to listen on.
+ */
+void run_server(const char* socket_path);
+
+/**
+ * @brief   Retrieves server statistics.
+ *
+ * @param   requests    Receives the number of requests served.
+ * @param   connections Receives the number of connections accepted.
+ */
+void server_stats(unsigned long* requests, unsigned long* connections);
+
+#endif /* SERVER_H */
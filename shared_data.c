@@ -10,13 +10,22 @@
  *          destroying the shared data among threads.
  */
 
+#include <stdatomic.h>
 #include "common.h"
 #include "utilities.h"
 #include "shared_data.h"
+#include "wal.h"
+#include "history.h"
+#include "replication.h"
 
 static SharedData* global_data = NULL;
 static pthread_mutex_t internal_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* Global order of writes, used to attribute the last writer IDs */
+static atomic_ulong write_seq = 0;
+static unsigned long last_incr_seq = 0;
+static unsigned long last_decr_seq = 0;
+
 /**
  * @brief   Initializes the shared data.
  * 
@@ -39,6 +48,8 @@ SharedData* init_shared_data()
     global_data->last_incr_id = -1;
     global_data->last_decr_id = -1;
     global_data->num_writers = 0;
+    last_incr_seq = 0;
+    last_decr_seq = 0;
 
     mutex_unlock(&internal_mutex);
     return global_data;
@@ -83,11 +94,60 @@ void modify_shared_data(int increment, int thread_id)
     global_data->sum += increment;
     if (increment > 0) {
         global_data->last_incr_id = thread_id;
+        last_incr_seq = next_write_seq();
     } else if (increment < 0) {
         global_data->last_decr_id = thread_id;
+        last_decr_seq = next_write_seq();
     }
     global_data->num_writers++;
 
+    /* Log the change in the same order it was applied */
+    wal_append(increment, thread_id, -1);
+    history_append(global_data->sum, thread_id);
+    replication_publish(global_data->sum, thread_id);
+
+    mutex_unlock(&internal_mutex);
+}
+
+/**
+ * @brief   Draws the next position in the global order of writes.
+ * 
+ * @return  A sequence number greater than any drawn before it.
+ */
+unsigned long next_write_seq()
+{
+    return atomic_fetch_add_explicit(&write_seq, 1, memory_order_relaxed) + 1;
+}
+
+/**
+ * @brief   Accounts for incrementer/decrementer pairs that cancelled out.
+ * 
+ * @param   pairs   Number of pairs to account for.
+ * @param   seq     Write sequence of the most recent pair.
+ * @param   incr_id Incrementer of the most recent pair.
+ * @param   decr_id Decrementer of the most recent pair.
+ */
+void apply_eliminated_pairs(unsigned long pairs, unsigned long seq,
+                            int incr_id, int decr_id)
+{
+    mutex_lock(&internal_mutex);
+
+    if (!global_data) {
+        mutex_unlock(&internal_mutex);
+        handle_error("Shared data not initialized");
+    }
+
+    /* The sum is unchanged, but both writers of each pair are counted */
+    global_data->num_writers += 2 * pairs;
+    if (seq > last_incr_seq) {
+        global_data->last_incr_id = incr_id;
+        last_incr_seq = seq;
+    }
+    if (seq > last_decr_seq) {
+        global_data->last_decr_id = decr_id;
+        last_decr_seq = seq;
+    }
+
     mutex_unlock(&internal_mutex);
 }
 
@@ -57,6 +57,28 @@ int read_shared_data();
  */
 void modify_shared_data(int increment, int thread_id);
 
+/**
+ * @brief   Draws the next position in the global order of writes.
+ * 
+ * @return  A sequence number greater than any drawn before it.
+ */
+unsigned long next_write_seq();
+
+/**
+ * @brief   Accounts for incrementer/decrementer pairs that cancelled out.
+ * 
+ * @details The sum is unchanged. Each pair counts as two writers, and the
+ *          pair's IDs become the last writer IDs if it completed after the
+ *          last write applied to the shared data.
+ * 
+ * @param   pairs   Number of pairs to account for.
+ * @param   seq     Write sequence of the most recent pair.
+ * @param   incr_id Incrementer of the most recent pair.
+ * @param   decr_id Decrementer of the most recent pair.
+ */
+void apply_eliminated_pairs(unsigned long pairs, unsigned long seq,
+                            int incr_id, int decr_id);
+
 /**
  * @brief   Frees and cleans up the shared data structure.
  */
@@ -0,0 +1,91 @@
+/**
+ * @file    slo.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements service level objective accounting.
+ */
+
+#include "common.h"
+#include "utilities.h"
+#include "slo.h"
+
+#define BASIS_POINTS 10000UL    /* Hundredths of a percent in a whole    */
+
+static SloCounts totals[NUM_FUNC];
+static pthread_mutex_t slo_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* const op_names[NUM_FUNC] = {
+    "reads", "increments", "decrements"
+};
+
+/**
+ * @brief   Clears the run totals before a new run.
+ */
+void slo_reset()
+{
+    mutex_lock(&slo_mutex);
+    memset(totals, 0, sizeof(totals));
+    mutex_unlock(&slo_mutex);
+}
+
+/**
+ * @brief   Adds a thread's outcome counts to the run totals.
+ *
+ * @param   op     READ_OP, INCR_OP or DECR_OP.
+ * @param   counts Outcome counts to add.
+ */
+void slo_merge(int op, const SloCounts* counts)
+{
+    mutex_lock(&slo_mutex);
+    SloCounts* total = &totals[OP_INDEX(op)];
+    total->met += counts->met;
+    total->late += counts->late;
+    total->timed_out += counts->timed_out;
+    mutex_unlock(&slo_mutex);
+}
+
+/**
+ * @brief   Prints one line of the report.
+ *
+ * @details The met rate is truncated rather than rounded, so it only reads
+ *          100% when every operation met the deadline.
+ *
+ * @param   name   Operation type name.
+ * @param   counts Outcome counts for that type.
+ */
+static void print_slo_line(const char* name, const SloCounts* counts)
+{
+    unsigned long ops = counts->met + counts->late + counts->timed_out;
+    unsigned long rate = ops ? counts->met * BASIS_POINTS / ops
+                             : BASIS_POINTS;
+
+    printf("\t%-11s met %3lu.%02lu%% (%lu/%lu), late %lu, timed out %lu\n",
+            name, rate / 100, rate % 100,
+            counts->met, ops, counts->late, counts->timed_out);
+}
+
+/**
+ * @brief   Prints the fraction of operations meeting the deadline and the
+ *          timeout breakdown by operation type.
+ *
+ * @param   deadline_us Per-operation deadline in microseconds.
+ */
+void print_slo_report(long deadline_us)
+{
+    SloCounts all = { 0, 0, 0 };
+
+    mutex_lock(&slo_mutex);
+    printf("Deadline %ld us per operation:\n", deadline_us);
+    for (int i = 0; i < NUM_FUNC; i++) {
+        print_slo_line(op_names[i], &totals[i]);
+        all.met += totals[i].met;
+        all.late += totals[i].late;
+        all.timed_out += totals[i].timed_out;
+    }
+    print_slo_line("all", &all);
+    mutex_unlock(&slo_mutex);
+}
+
+/* end slo.c */
@@ -0,0 +1,55 @@
+/**
+ * @file    slo.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares service level objective accounting for timed operations.
+ *
+ * @details When operations run with a deadline, each one either completes
+ *          in time, completes late (the locks were acquired in time but the
+ *          operation finished after the deadline), or times out waiting for
+ *          a lock and is abandoned. Counts are kept per operation type.
+ */
+
+#ifndef SLO_H
+#define SLO_H
+
+/**
+ * @struct  SloCounts
+ *
+ * @brief   Outcome counts for one operation type.
+ */
+typedef struct {
+    unsigned long met;          /* Completed before the deadline        */
+    unsigned long late;         /* Completed after the deadline         */
+    unsigned long timed_out;    /* Abandoned waiting for a lock         */
+} SloCounts;
+
+/**
+ * @brief   Clears the run totals before a new run.
+ *
+ * @details Must only be called while no threads are merging counts.
+ */
+void slo_reset();
+
+/**
+ * @brief   Adds a thread's outcome counts to the run totals.
+ *
+ * @details Threads count locally and merge once when they finish, so the
+ *          accounting adds no shared writes to the operation path.
+ *
+ * @param   op     READ_OP, INCR_OP or DECR_OP.
+ * @param   counts Outcome counts to add.
+ */
+void slo_merge(int op, const SloCounts* counts);
+
+/**
+ * @brief   Prints the fraction of operations meeting the deadline and the
+ *          timeout breakdown by operation type.
+ *
+ * @param   deadline_us Per-operation deadline in microseconds.
+ */
+void print_slo_report(long deadline_us);
+
+#endif /* SLO_H */
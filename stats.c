@@ -0,0 +1,230 @@
+/**
+ * @file    stats.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements per-thread operation counters.
+ *
+ * @details Latencies are kept in a log-linear histogram: each power of two
+ *          is split into LATENCY_SUB_BUCKETS equal buckets, so a percentile
+ *          is accurate to within a quarter of its value.
+ */
+
+#include "common.h"
+#include "utilities.h"
+#include "stats.h"
+
+static ThreadStats* slots = NULL;
+static int num_slots = 0;
+static int timing = 0;
+static atomic_int next_slot = 0;
+static _Thread_local ThreadStats* my_stats = NULL;
+
+/**
+ * @brief   Adds to a counter that only the calling thread writes.
+ *
+ * @param   counter Counter owned by the calling thread.
+ * @param   amount  Amount to add.
+ */
+static void owned_add(atomic_ulong* counter, unsigned long amount)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter,
+            memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/**
+ * @brief   Maps a latency to its histogram bucket.
+ *
+ * @param   ns Latency in nanoseconds.
+ *
+ * @return  Bucket index.
+ */
+static int latency_bucket(unsigned long ns)
+{
+    if (ns < LATENCY_SUB_BUCKETS) {
+        return (int)ns;
+    }
+    int msb = 63 - __builtin_clzl(ns);
+    int bucket = msb * LATENCY_SUB_BUCKETS +
+                 (int)((ns >> (msb - 2)) & (LATENCY_SUB_BUCKETS - 1));
+    return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+/**
+ * @brief   Finds the largest latency a histogram bucket holds.
+ *
+ * @param   bucket Bucket index.
+ *
+ * @return  Upper bound of the bucket in nanoseconds.
+ */
+static long bucket_limit(int bucket)
+{
+    if (bucket < LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    int msb = bucket / LATENCY_SUB_BUCKETS;
+    long width = 1L << (msb - 2);
+    return (LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS + 1) * width - 1;
+}
+
+/**
+ * @brief   Allocates counter slots for a run.
+ *
+ * @param   max_threads Number of threads that may register.
+ * @param   timed       Also measure lock wait time and operation latency.
+ */
+void stats_init(int max_threads, int timed)
+{
+    slots = aligned_alloc(CACHE_LINE_SIZE, max_threads * sizeof(ThreadStats));
+    if (!slots) {
+        handle_error("Error allocating memory for thread statistics");
+    }
+    for (int i = 0; i < max_threads; i++) {
+        for (int op = 0; op < NUM_FUNC; op++) {
+            atomic_init(&slots[i].ops[op], 0);
+        }
+        atomic_init(&slots[i].lock_wait_ns, 0);
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            atomic_init(&slots[i].latency[b], 0);
+        }
+    }
+    num_slots = max_threads;
+    timing = timed;
+    atomic_store(&next_slot, 0);
+}
+
+/**
+ * @brief   Claims a counter slot for the calling thread.
+ */
+void stats_register()
+{
+    int slot = atomic_fetch_add(&next_slot, 1);
+    my_stats = slot < num_slots ? &slots[slot] : NULL;
+}
+
+/**
+ * @brief   Counts one completed operation for the calling thread.
+ *
+ * @param   op    READ_OP, INCR_OP or DECR_OP.
+ * @param   start Value returned by stats_begin() when the operation started.
+ */
+void stats_count(int op, long start)
+{
+    if (my_stats) {
+        owned_add(&my_stats->ops[OP_INDEX(op)], 1);
+    }
+    if (start) {
+        owned_add(&my_stats->latency[latency_bucket(monotonic_ns() - start)],
+                  1);
+    }
+}
+
+/**
+ * @brief   Reads the monotonic clock.
+ *
+ * @return  Current time in nanoseconds.
+ */
+long monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief   Starts timing an operation or a lock acquisition.
+ *
+ * @return  Start timestamp in nanoseconds, or 0 if not timing.
+ */
+long stats_begin()
+{
+    return (timing && my_stats) ? monotonic_ns() : 0;
+}
+
+/**
+ * @brief   Finishes timing a lock acquisition for the calling thread.
+ *
+ * @param   start Value returned by stats_begin().
+ */
+void stats_wait_end(long start)
+{
+    if (start) {
+        owned_add(&my_stats->lock_wait_ns, monotonic_ns() - start);
+    }
+}
+
+/**
+ * @brief   Sums every thread's counters without taking any locks.
+ *
+ * @param   totals Receives the sums.
+ */
+void stats_totals(StatsTotals* totals)
+{
+    memset(totals, 0, sizeof(*totals));
+    for (int i = 0; i < num_slots; i++) {
+        for (int op = 0; op < NUM_FUNC; op++) {
+            totals->ops[op] += atomic_load_explicit(&slots[i].ops[op],
+                                                    memory_order_relaxed);
+        }
+        totals->lock_wait_ns += atomic_load_explicit(&slots[i].lock_wait_ns,
+                                                     memory_order_relaxed);
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            totals->latency[b] += atomic_load_explicit(&slots[i].latency[b],
+                                                       memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief   Finds a latency percentile in summed counters.
+ *
+ * @param   totals Counters from stats_totals().
+ * @param   pct    Percentile, from 0 to 100.
+ *
+ * @details Interpolates linearly within the bucket holding the percentile,
+ *          so that small shifts are not rounded to a whole bucket, which
+ *          spans up to a quarter of its value.
+ *
+ * @return  The percentile in nanoseconds, or 0 if no latencies were
+ *          recorded.
+ */
+long stats_percentile(const StatsTotals* totals, double pct)
+{
+    unsigned long count = 0, seen = 0;
+
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        count += totals->latency[b];
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    /* Rank of the percentile, counting from 1 */
+    unsigned long rank = (unsigned long)(pct / 100.0 * (count - 1)) + 1;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        unsigned long in_bucket = totals->latency[b];
+        if (seen + in_bucket >= rank) {
+            /* Spread the bucket's latencies evenly across its range */
+            long lower = b == 0 ? 0 : bucket_limit(b - 1) + 1;
+            long width = bucket_limit(b) - lower + 1;
+            long offset = (long)(width * (double)(rank - seen) /
+                                 in_bucket) - 1;
+            return lower + (offset > 0 ? offset : 0);
+        }
+        seen += in_bucket;
+    }
+    return bucket_limit(LATENCY_BUCKETS - 1);
+}
+
+/**
+ * @brief   Frees the counter slots.
+ */
+void destroy_stats()
+{
+    free(slots);
+    slots = NULL;
+    num_slots = 0;
+}
+
+/* end stats.c */
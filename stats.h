@@ -0,0 +1,115 @@
+/**
+ * @file    stats.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares per-thread operation counters.
+ *
+ * @details Each worker thread owns one cache-line-sized slot and is the only
+ *          writer to it, so counting needs no locks or atomic
+ *          read-modify-write instructions. Other threads can sum the slots
+ *          at any time with plain atomic loads, without disturbing the
+ *          data and reader semaphores.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdatomic.h>
+#include "common.h"
+
+#define LATENCY_SUB_BUCKETS 4       /* Histogram buckets per power of two */
+#define LATENCY_BUCKETS 160         /* Covers latencies up to ~1000 s     */
+#define TAIL_PERCENTILE 99.0        /* Percentile reported as tail latency */
+
+/**
+ * @struct  ThreadStats
+ *
+ * @brief   Counters owned by one worker thread.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_ulong ops[NUM_FUNC];
+    atomic_ulong lock_wait_ns;  /* Time spent acquiring locks           */
+    atomic_ulong latency[LATENCY_BUCKETS];  /* Operation latency counts */
+} ThreadStats;
+
+/**
+ * @struct  StatsTotals
+ *
+ * @brief   Sum of every thread's counters at one point in time.
+ */
+typedef struct {
+    unsigned long ops[NUM_FUNC];    /* Completed operations by type     */
+    unsigned long lock_wait_ns;     /* Total lock acquisition time      */
+    unsigned long latency[LATENCY_BUCKETS]; /* Latency histogram        */
+} StatsTotals;
+
+/**
+ * @brief   Allocates counter slots for a run.
+ *
+ * @param   max_threads Number of threads that may register.
+ * @param   timed       Also measure lock wait time and operation latency.
+ */
+void stats_init(int max_threads, int timed);
+
+/**
+ * @brief   Claims a counter slot for the calling thread.
+ *
+ * @details Threads that find no free slot simply go uncounted.
+ */
+void stats_register();
+
+/**
+ * @brief   Starts timing an operation or a lock acquisition.
+ *
+ * @return  Start timestamp in nanoseconds, or 0 if not timing.
+ */
+long stats_begin();
+
+/**
+ * @brief   Counts one completed operation for the calling thread.
+ *
+ * @param   op    READ_OP, INCR_OP or DECR_OP.
+ * @param   start Value returned by stats_begin() when the operation started.
+ */
+void stats_count(int op, long start);
+
+/**
+ * @brief   Finishes timing a lock acquisition for the calling thread.
+ *
+ * @param   start Value returned by stats_begin().
+ */
+void stats_wait_end(long start);
+
+/**
+ * @brief   Sums every thread's counters without taking any locks.
+ *
+ * @param   totals Receives the sums.
+ */
+void stats_totals(StatsTotals* totals);
+
+/**
+ * @brief   Finds a latency percentile in summed counters.
+ *
+ * @param   totals Counters from stats_totals().
+ * @param   pct    Percentile, from 0 to 100.
+ *
+ * @return  The percentile in nanoseconds, interpolated linearly within
+ *          the bucket holding it, or 0 if no latencies were recorded.
+ */
+long stats_percentile(const StatsTotals* totals, double pct);
+
+/**
+ * @brief   Frees the counter slots.
+ */
+void destroy_stats();
+
+/**
+ * @brief   Reads the monotonic clock.
+ *
+ * @return  Current time in nanoseconds.
+ */
+long monotonic_ns();
+
+#endif /* STATS_H */
@@ -8,76 +8,455 @@
  * 
  * @details Contains functions related to thread operations such as 
  *          creating, joining, reading, incrementing, and decrementing.
+ *          Build with one of KERNELS_GENERIC, KERNELS_SEM or KERNELS_MCS
+ *          defined to limit which writer lock schemes get specialized
+ *          thread kernels; by default every scheme that can have them
+ *          does.
  */
 
+#define _GNU_SOURCE             /* pthread_attr_setaffinity_np() */
+#include <sched.h>
+#include <unistd.h>
 #include "common.h"
 #include "resources.h"
 #include "utilities.h"
+#include "arg_parser.h"
+#include "elimination.h"
+#include "wal.h"
+#include "history.h"
+#include "delegation.h"
+#include "replication.h"
+#include "slo.h"
+#include "stats.h"
+#include "schedule.h"
 #include "thread_operations.h"
 
+/* Without a KERNELS_* build flag, specialize every scheme that has one */
+#if !defined(KERNELS_GENERIC) && !defined(KERNELS_SEM) && \
+    !defined(KERNELS_MCS)
+#define KERNELS_SEM
+#define KERNELS_MCS
+#endif
+
+/* SMT siblings of the first CPU, which the compact layout packs onto */
+#define COMPACT_SIBLINGS \
+    "/sys/devices/system/cpu/cpu0/topology/thread_siblings_list"
+#define COMPACT_MIN_CPUS 2      /* CPUs used without SMT siblings        */
+
 /**
- * @brief   Performs shared data operations based on increment.
+ * @struct  KernelSet
+ *
+ * @brief   Thread functions specialized for one writer lock scheme.
+ */
+typedef struct {
+    int scheme;                     /* WRITER_LOCK_* scheme, -1 at the end */
+    void* (*incrementer)(void*);
+    void* (*decrementer)(void*);
+    void* (*reader)(void*);
+} KernelSet;
+
+static atomic_int stop_flag = 0;
+static int run_until_stopped = 0;
+
+/**
+ * @brief   Asks threads in a timed run to finish their current operation
+ *          and exit.
+ */
+void stop_threads()
+{
+    atomic_store_explicit(&stop_flag, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief   Checks whether threads in a timed run should stop.
  * 
- * @param   arg Pointer to the thread ID.
- * @param   increment Value indicating operation type (read/modify).
+ * @return  1 once stop_threads() has been called, 0 before.
+ */
+static int stop_requested()
+{
+    return atomic_load_explicit(&stop_flag, memory_order_relaxed);
+}
+
+/**
+ * @brief   Locks a semaphore, optionally giving up at a deadline.
  * 
- * @return  NULL
+ * @param   semaphore Semaphore to lock.
+ * @param   deadline  Absolute deadline, or NULL to wait indefinitely.
+ * 
+ * @return  1 if the semaphore was locked, 0 if the deadline passed.
  */
-void* shared_data_operation(void* arg, int increment)
+static inline int sem_acquire(sem_t* semaphore,
+                              const struct timespec* deadline)
 {
-    /* Retrieve the thread ID from argument */
-    int id = *(int*)arg;
-    free(arg);
+    if (!deadline) {
+        sem_lock(semaphore);
+        return 1;
+    }
+    return sem_lock_timed(semaphore, deadline);
+}
 
-    /* Access the resources */
-    Resources* rsc = get_resources();
+/**
+ * @brief   Acquires exclusive access to the shared data for a writer.
+ * 
+ * @details With the MCS writer lock, writers first queue on their own node so
+ *          that they are admitted one at a time in FIFO order, and only the
+ *          writer at the head of the queue competes with readers for the
+ *          data semaphore. A queued MCS waiter cannot leave the queue, so a
+ *          writer with a deadline polls for an empty queue instead and gives
+ *          up FIFO order for the ability to time out.
+ * 
+ * @param   rsc      Shared resources.
+ * @param   scheme   WRITER_LOCK_* scheme in use.
+ * @param   node     Caller-owned queue node, used by the MCS writer lock.
+ * @param   deadline Absolute deadline, or NULL to wait indefinitely.
+ * 
+ * @return  1 if access was acquired, 0 if the deadline passed.
+ */
+static inline int writer_lock(Resources* rsc, int scheme, QueueNode* node,
+                              const struct timespec* deadline)
+{
+    if (scheme == WRITER_LOCK_MCS) {
+        if (!deadline) {
+            queue_lock_acquire(&rsc->writer_queue, node);
+        } else {
+            while (!queue_lock_try_acquire(&rsc->writer_queue, node)) {
+                if (deadline_passed(deadline)) {
+                    return 0;
+                }
+                sched_yield();
+            }
+        }
+    }
+    if (!sem_acquire(&rsc->data_sem, deadline)) {
+        if (scheme == WRITER_LOCK_MCS) {
+            queue_lock_release(&rsc->writer_queue, node);
+        }
+        return 0;
+    }
+    return 1;
+}
 
-    /* Access the shared data */
-    SharedData *data = get_shared_data();
+/**
+ * @brief   Acquires exclusive access for a writer only if uncontended.
+ * 
+ * @details With the MCS writer lock, being first in an empty queue counts as
+ *          uncontended; the writer then waits only for any active readers.
+ * 
+ * @param   rsc      Shared resources.
+ * @param   node     Caller-owned queue node, used by the MCS writer lock.
+ * @param   deadline Absolute deadline, or NULL to wait indefinitely.
+ * 
+ * @return  1 if access was acquired, 0 if the lock is contended or the
+ *          deadline passed while waiting for readers.
+ */
+static int writer_try_lock(Resources* rsc, QueueNode* node,
+                           const struct timespec* deadline)
+{
+    if (rsc->writer_lock == WRITER_LOCK_MCS) {
+        if (!queue_lock_try_acquire(&rsc->writer_queue, node)) {
+            return 0;
+        }
+        if (!sem_acquire(&rsc->data_sem, deadline)) {
+            queue_lock_release(&rsc->writer_queue, node);
+            return 0;
+        }
+        return 1;
+    }
+    return sem_try_lock(&rsc->data_sem);
+}
 
-    if (increment == 0) {  /* Read operation */
+/**
+ * @brief   Releases exclusive access to the shared data for a writer.
+ * 
+ * @details The data semaphore is posted before the queue is advanced so the
+ *          next queued writer usually finds it free and does not park.
+ * 
+ * @param   rsc    Shared resources.
+ * @param   scheme WRITER_LOCK_* scheme passed to writer_lock().
+ * @param   node   Queue node passed to writer_lock().
+ */
+static inline void writer_unlock(Resources* rsc, int scheme, QueueNode* node)
+{
+    sem_unlock(&rsc->data_sem);
+    if (scheme == WRITER_LOCK_MCS) {
+        queue_lock_release(&rsc->writer_queue, node);
+    }
+}
+
+/**
+ * @brief   Reads the shared sum using the readers protocol, optionally
+ *          giving up at a deadline.
+ * 
+ * @details If the first reader times out waiting for the data semaphore, it
+ *          withdraws from the reader count so the next reader can try. With
+ *          replicas the read is served by a replica, and in delegation mode
+ *          it is handed to the owner thread instead.
+ * 
+ * @param   id       ID of the reading thread.
+ * @param   deadline Absolute deadline, or NULL to wait indefinitely.
+ * @param   value    Receives the value read.
+ * 
+ * @return  OP_OK, or OP_TIMEOUT if the deadline passed first.
+ */
+int timed_read_operation(int id, const struct timespec* deadline, int* value)
+{
+    Resources* rsc = get_resources();
+    SharedData* data = get_shared_data();
+    long wait_start = stats_begin();
 
-        /* Lock to increment reader count */
-        sem_lock(&rsc->reader_sem);
-        rsc->readers_count++;
+    /* With replicas, reads never touch the primary at all */
+    if (replicas_enabled()) {
+        *value = replica_read(id);
+        stats_wait_end(wait_start);
+        if (!get_options()->quiet) {
+            printf("Reader %d got %d\n", id, *value);
+        }
+        return OP_OK;
+    }
 
-        /* If first reader, lock access to data */
-        if (rsc->readers_count == 1) {
-            sem_lock(&rsc->data_sem);
+    /* In delegation mode the owner thread reads the sum for us */
+    if (rsc->writer_lock == WRITER_LOCK_DELEGATE) {
+        int status = delegate_operation(READ_OP, id, deadline, value);
+        stats_wait_end(wait_start);
+        if (status == OP_OK && !get_options()->quiet) {
+            printf("Reader %d got %d\n", id, *value);
         }
-        sem_unlock(&rsc->reader_sem);
+        return status;
+    }
 
-        /* Read the shared data value */
-        int value = data->sum;
-        printf("Reader %d got %d\n", id, value);
+    /* Lock to increment reader count */
+    if (!sem_acquire(&rsc->reader_sem, deadline)) {
+        stats_wait_end(wait_start);
+        return OP_TIMEOUT;
+    }
+    rsc->readers_count++;
 
-        /* Lock to decrement reader count */
-        sem_lock(&rsc->reader_sem);
+    /* If first reader, lock access to data */
+    if (rsc->readers_count == 1 && !sem_acquire(&rsc->data_sem, deadline)) {
         rsc->readers_count--;
+        sem_unlock(&rsc->reader_sem);
+        stats_wait_end(wait_start);
+        return OP_TIMEOUT;
+    }
+    sem_unlock(&rsc->reader_sem);
+    stats_wait_end(wait_start);
+    schedule_event(READ_OP, id, SCHED_ACQUIRE);
+
+    /* Read the shared data value */
+    *value = data->sum;
+    if (!get_options()->quiet) {
+        printf("Reader %d got %d\n", id, *value);
+    }
+
+    /* Lock to decrement reader count */
+    sem_lock(&rsc->reader_sem);
+    rsc->readers_count--;
+
+    /* If last reader, unlock access to data */
+    if (rsc->readers_count == 0) {
+        sem_unlock(&rsc->data_sem);
+    }
+    sem_unlock(&rsc->reader_sem);
+    schedule_event(READ_OP, id, SCHED_RELEASE);
+
+    return OP_OK;
+}
+
+/**
+ * @brief   Reads the shared sum using the readers protocol.
+ * 
+ * @param   id ID of the reading thread.
+ * 
+ * @return  The value read.
+ */
+int read_operation(int id)
+{
+    int value;
+    timed_read_operation(id, NULL, &value);
+    return value;
+}
+
+/**
+ * @brief   Adjusts the shared sum using the writers protocol, optionally
+ *          giving up at a deadline.
+ * 
+ * @details In delegation mode the write is handed to the owner thread.
+ *          When elimination is enabled and the writer lock is contended, the
+ *          writer first tries to cancel out against a writer of the opposite
+ *          sign, and only queues for the lock if no partner turns up. The
+ *          change may not be durable yet; callers that need it persisted
+ *          follow up with wal_sync().
+ * 
+ * @param   increment Value to add to the sum.
+ * @param   id        ID of the writing thread.
+ * @param   deadline  Absolute deadline, or NULL to wait indefinitely.
+ * @param   value     Receives the sum after the write.
+ * 
+ * @return  OP_OK, or OP_TIMEOUT if the deadline passed first.
+ */
+int timed_write_operation(int increment, int id,
+                          const struct timespec* deadline, int* value)
+{
+    Resources* rsc = get_resources();
+    SharedData* data = get_shared_data();
+    QueueNode node;
+    long wait_start = stats_begin();
 
-        /* If last reader, unlock access to data */
-        if (rsc->readers_count == 0) {
-            sem_unlock(&rsc->data_sem);
+    /* In delegation mode the owner thread applies the write for us */
+    if (rsc->writer_lock == WRITER_LOCK_DELEGATE) {
+        int status = delegate_operation(increment, id, deadline, value);
+        stats_wait_end(wait_start);
+        if (status == OP_OK && !get_options()->quiet) {
+            printf("%s %d set sum = %d\n",
+                    increment > 0 ? "Incrementer" : "Decrementer", id, *value);
         }
-        sem_unlock(&rsc->reader_sem);
+        return status;
+    }
+
+    /* Lock to ensure exclusive data access, or cancel out if contended */
+    if (!get_options()->elimination) {
+        if (!writer_lock(rsc, rsc->writer_lock, &node, deadline)) {
+            stats_wait_end(wait_start);
+            return OP_TIMEOUT;
+        }
+    } else if (!writer_try_lock(rsc, &node, deadline)) {
+        int partner = eliminate(increment, id);
+        if (partner >= 0) {
+            stats_wait_end(wait_start);
+            if (!get_options()->quiet) {
+                printf("%s %d cancelled out with %s %d\n",
+                        increment > 0 ? "Incrementer" : "Decrementer", id,
+                        increment > 0 ? "decrementer" : "incrementer",
+                        partner);
+            }
+            /* The pair left the sum as it was */
+            *value = __atomic_load_n(&data->sum, __ATOMIC_RELAXED);
+            return OP_OK;
+        }
+        if (!writer_lock(rsc, rsc->writer_lock, &node, deadline)) {
+            stats_wait_end(wait_start);
+            return OP_TIMEOUT;
+        }
+    }
+    stats_wait_end(wait_start);
+    schedule_event(increment, id, SCHED_ACQUIRE);
 
-    } else {  /* Write operation */
+    /* Modify shared data and print updates */
+    modify_shared_data(increment, id);
+    *value = data->sum;
+    if (!get_options()->quiet) {
+        printf("%s %d set sum = %d\n",
+                increment > 0 ? "Incrementer" : "Decrementer", id, *value);
+    }
 
-        /* Lock to ensure exclusive data access */
-        sem_lock(&rsc->data_sem);
+    /* Unlock to allow access to other threads */
+    writer_unlock(rsc, rsc->writer_lock, &node);
+    schedule_event(increment, id, SCHED_RELEASE);
 
-        /* Modify shared data and print updates */
-        modify_shared_data(increment, id);
-        if (increment > 0) {
-            printf("Incrementer %d set sum = %d\n", id, data->sum);
-        } else {
-            printf("Decrementer %d set sum = %d\n", id, data->sum);
+    return OP_OK;
+}
+
+/**
+ * @brief   Adjusts the shared sum using the writers protocol.
+ * 
+ * @param   increment Value to add to the sum.
+ * @param   id        ID of the writing thread.
+ * 
+ * @return  The sum after the write.
+ */
+int write_operation(int increment, int id)
+{
+    int value;
+    timed_write_operation(increment, id, NULL, &value);
+    return value;
+}
+
+/**
+ * @brief   Performs one operation against a deadline and classifies it.
+ * 
+ * @param   increment Value indicating operation type (read/modify).
+ * @param   id        ID of the thread.
+ * @param   counts    Outcome counts to update.
+ * 
+ * @return  OP_OK, or OP_TIMEOUT if the operation was abandoned.
+ */
+static int deadline_operation(int increment, int id, SloCounts* counts)
+{
+    struct timespec deadline;
+    int value, status;
+
+    deadline_after(&deadline, get_options()->deadline_us);
+    if (increment == 0) {
+        status = timed_read_operation(id, &deadline, &value);
+    } else {
+        status = timed_write_operation(increment, id, &deadline, &value);
+        if (status == OP_OK) {
+            wal_sync();
         }
+    }
 
-        /* Unlock to allow access to other threads */
-        sem_unlock(&rsc->data_sem);
+    if (status == OP_TIMEOUT) {
+        counts->timed_out++;
+        if (!get_options()->quiet) {
+            printf("%s %d timed out\n", increment > 0 ? "Incrementer" :
+                    increment < 0 ? "Decrementer" : "Reader", id);
+        }
+    } else if (deadline_passed(&deadline)) {
+        counts->late++;
+    } else {
+        counts->met++;
+    }
+    return status;
+}
+
+/**
+ * @brief   Performs shared data operations based on increment.
+ * 
+ * @details Repeats the operation for the configured number of operations
+ *          per thread, or until stop_threads() in a timed run. With a
+ *          deadline configured, each operation is bounded by it and its
+ *          outcome is counted towards the SLO report. Completed operations
+ *          are counted in the thread's own statistics slot, and every
+ *          request for the lock is traced when recording.
+ * 
+ * @param   arg Pointer to the thread ID.
+ * @param   increment Value indicating operation type (read/modify).
+ * 
+ * @return  NULL
+ */
+void* shared_data_operation(void* arg, int increment)
+{
+    SloCounts counts = { 0, 0, 0 };
+
+    /* Retrieve the thread ID from argument */
+    int id = *(int*)arg;
+    free(arg);
+
+    stats_register();
+
+    int ops = get_options()->ops_per_thread;
+    for (int i = 0; run_until_stopped ? !stop_requested() : i < ops; i++) {
+        long start = stats_begin();
+        int status = OP_OK;
+        schedule_event(increment, id, SCHED_REQUEST);
+        if (get_options()->deadline_us > 0) {  /* Deadline-bounded */
+            status = deadline_operation(increment, id, &counts);
+        } else if (increment == 0) {  /* Read operation */
+            read_operation(id);
+        } else {  /* Write operation */
+            write_operation(increment, id);
+
+            /* Wait for the change to be group committed, outside the lock */
+            wal_sync();
+        }
+        if (status == OP_OK) {
+            stats_count(increment, start);
+        }
     }
 
+    if (get_options()->deadline_us > 0) {
+        slo_merge(increment, &counts);
+    }
     return NULL;
 }
 
@@ -117,6 +496,211 @@ void* reader(void* arg)
     return shared_data_operation(arg, READ_OP);
 }
 
+/**
+ * @brief   Performs one thread's operations with the operation type and
+ *          writer lock scheme fixed.
+ * 
+ * @details Covers the common configuration of shared_data_operation(): no
+ *          deadline, elimination, replicas, delegation or lock tracing.
+ *          Always inlined into kernels that pass constants, so the compiler
+ *          drops every branch on the operation and scheme from the loop.
+ * 
+ * @param   arg       Pointer to the thread ID.
+ * @param   increment Operation type, a constant READ_OP, INCR_OP or DECR_OP.
+ * @param   scheme    Constant WRITER_LOCK_SEM or WRITER_LOCK_MCS.
+ * 
+ * @return  NULL
+ */
+static inline __attribute__((always_inline))
+void* kernel_loop(void* arg, int increment, int scheme)
+{
+    Resources* rsc = get_resources();
+    SharedData* data = get_shared_data();
+    int quiet = get_options()->quiet;
+    int ops = get_options()->ops_per_thread;
+
+    int id = *(int*)arg;
+    free(arg);
+
+    stats_register();
+
+    for (int i = 0; run_until_stopped ? !stop_requested() : i < ops; i++) {
+        long start = stats_begin();
+        if (increment == READ_OP) {
+            sem_lock(&rsc->reader_sem);
+            if (++rsc->readers_count == 1) {
+                sem_lock(&rsc->data_sem);
+            }
+            sem_unlock(&rsc->reader_sem);
+            stats_wait_end(start);
+
+            int value = data->sum;
+            if (!quiet) {
+                printf("Reader %d got %d\n", id, value);
+            }
+
+            sem_lock(&rsc->reader_sem);
+            if (--rsc->readers_count == 0) {
+                sem_unlock(&rsc->data_sem);
+            }
+            sem_unlock(&rsc->reader_sem);
+        } else {
+            QueueNode node;
+            writer_lock(rsc, scheme, &node, NULL);
+            stats_wait_end(start);
+
+            modify_shared_data(increment, id);
+            if (!quiet) {
+                printf("%s %d set sum = %d\n", increment > 0 ?
+                        "Incrementer" : "Decrementer", id, data->sum);
+            }
+            writer_unlock(rsc, scheme, &node);
+            wal_sync();
+        }
+        stats_count(increment, start);
+    }
+    return NULL;
+}
+
+/* Generates the reader, incrementer and decrementer kernels of a scheme */
+#define DEFINE_KERNELS(name, scheme)                                    \
+    static void* name##_incrementer(void* arg)                          \
+    {                                                                   \
+        return kernel_loop(arg, INCR_OP, scheme);                       \
+    }                                                                   \
+    static void* name##_decrementer(void* arg)                          \
+    {                                                                   \
+        return kernel_loop(arg, DECR_OP, scheme);                       \
+    }                                                                   \
+    static void* name##_reader(void* arg)                               \
+    {                                                                   \
+        return kernel_loop(arg, READ_OP, scheme);                       \
+    }
+
+#define KERNEL_SET(name, scheme) \
+    { scheme, name##_incrementer, name##_decrementer, name##_reader }
+
+#ifdef KERNELS_SEM
+DEFINE_KERNELS(sem, WRITER_LOCK_SEM)
+#endif
+#ifdef KERNELS_MCS
+DEFINE_KERNELS(mcs, WRITER_LOCK_MCS)
+#endif
+
+static const KernelSet kernel_sets[] = {
+#ifdef KERNELS_SEM
+    KERNEL_SET(sem, WRITER_LOCK_SEM),
+#endif
+#ifdef KERNELS_MCS
+    KERNEL_SET(mcs, WRITER_LOCK_MCS),
+#endif
+    { -1, NULL, NULL, NULL }
+};
+
+/**
+ * @brief   Picks the specialized kernels for the current configuration.
+ * 
+ * @return  Kernels for the writer lock scheme, or NULL if the run needs
+ *          the general operation loop.
+ */
+static const KernelSet* select_kernels()
+{
+    Options* options = get_options();
+
+    if (options->deadline_us > 0 || options->elimination ||
+        replicas_enabled() || schedule_recording()) {
+        return NULL;
+    }
+    for (const KernelSet* set = kernel_sets; set->scheme >= 0; set++) {
+        if (set->scheme == get_resources()->writer_lock) {
+            return set;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief   Lists the CPUs that the compact layout packs threads onto.
+ * 
+ * @details Uses the SMT siblings of CPU 0, so that compact threads share
+ *          one physical core. Without SMT, or if the topology cannot be
+ *          read, the first COMPACT_MIN_CPUS CPUs are used. At least one
+ *          online CPU is always left out, so compact never matches spread.
+ * 
+ * @param   cpus     Receives the CPU numbers.
+ * @param   num_cpus Number of online CPUs.
+ * 
+ * @return  Number of CPUs listed.
+ */
+static int compact_cpus(int cpus[], long num_cpus)
+{
+    long limit = num_cpus > 1 ? num_cpus - 1 : 1;
+    int count = 0;
+    int first, last;
+    FILE* file = fopen(COMPACT_SIBLINGS, "r");
+
+    /* The list holds ranges such as "0-1" or single CPUs such as "0,4" */
+    while (file && count < limit && fscanf(file, "%d", &first) == 1) {
+        last = first;
+        if (fscanf(file, "-%d", &last) != 1) {
+            last = first;
+        }
+        for (int cpu = first; cpu <= last && count < limit; cpu++) {
+            if (cpu >= 0 && cpu < num_cpus) {
+                cpus[count++] = cpu;
+            }
+        }
+        if (fgetc(file) != ',') {
+            break;
+        }
+    }
+    if (file) {
+        fclose(file);
+    }
+
+    if (count < 2) {
+        count = 0;
+        while (count < COMPACT_MIN_CPUS && count < limit) {
+            cpus[count] = count;
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief   Pins a thread to a CPU according to the affinity layout.
+ * 
+ * @details Compact packs every thread onto the few CPUs listed by
+ *          compact_cpus(), round-robin; spread deals threads out
+ *          round-robin over every CPU so neighbours land on different
+ *          CPUs.
+ * 
+ * @param   attr  Attributes of the thread about to be created.
+ * @param   index Index of the thread among all threads.
+ */
+static void set_affinity(pthread_attr_t* attr, int index)
+{
+    int affinity = get_options()->affinity;
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t cpus;
+
+    if (affinity == AFFINITY_NONE || num_cpus < 1) {
+        return;
+    }
+    CPU_ZERO(&cpus);
+    if (affinity == AFFINITY_COMPACT) {
+        int packed[CPU_SETSIZE];
+        int count = compact_cpus(packed, num_cpus);
+        CPU_SET(packed[index % count], &cpus);
+    } else {
+        CPU_SET(index % num_cpus, &cpus);
+    }
+    if (pthread_attr_setaffinity_np(attr, sizeof(cpus), &cpus) != 0) {
+        handle_error("Error setting thread affinity");
+    }
+}
+
 /**
  * @brief   Creates a specified number of threads of a certain type.
  * 
@@ -140,6 +724,7 @@ int create_threads (pthread_t threads[], int max_threads, int start_index,
 
     /* Loop to create and initialize threads */
     for (int i = 0; i < num_threads; i++) {
+        pthread_attr_t attr;
         int* thread_id = malloc(sizeof(int));
         if (!thread_id) {
             char errorMsg[MAX_STRING];
@@ -150,9 +735,13 @@ int create_threads (pthread_t threads[], int max_threads, int start_index,
         }
         *thread_id = i;
 
-        /* Create the thread and handle errors */
-        if (pthread_create(&threads[start_index + i], 
-            NULL, thread_type, thread_id)) {
+        /* Create the thread on its CPU and handle errors */
+        pthread_attr_init(&attr);
+        set_affinity(&attr, start_index + i);
+        int err = pthread_create(&threads[start_index + i], 
+                                 &attr, thread_type, thread_id);
+        pthread_attr_destroy(&attr);
+        if (err) {
             free(thread_id);
             char errorMsg[MAX_STRING];
             snprintf(errorMsg, sizeof(errorMsg),
@@ -185,4 +774,114 @@ void join_threads(pthread_t threads[], int count)
     }
 }
 
+/**
+ * @brief   Runs a full set of worker threads and waits for them to finish.
+ * 
+ * @details With a duration, the threads keep operating until it has passed
+ *          rather than stopping after the configured number of operations.
+ *          When the configuration allows, the threads run the kernels
+ *          specialized for the writer lock scheme. Each run starts with an
+ *          empty elimination array and fresh deadline totals.
+ * 
+ * @param   num_incrementers Incrementer threads to create.
+ * @param   num_decrementers Decrementer threads to create.
+ * @param   num_readers      Reader threads to create.
+ * @param   duration_ms      How long to run, or 0 to run every operation.
+ */
+void run_workers(int num_incrementers, int num_decrementers, int num_readers,
+                 long duration_ms)
+{
+    pthread_t* threads = get_resources()->threads;
+    int max_threads = num_incrementers + num_decrementers + num_readers;
+    const KernelSet* kernels = select_kernels();
+    int count = 0;
+
+    atomic_store(&stop_flag, 0);
+    run_until_stopped = duration_ms > 0;
+    elimination_init();
+    slo_reset();
+
+    /* Create threads for incrementers, decrementers, and readers. */
+    count = create_threads(threads, max_threads, count, num_incrementers,
+                            kernels ? kernels->incrementer : incrementer,
+                            "incrementer");
+    count = create_threads(threads, max_threads, count, num_decrementers,
+                            kernels ? kernels->decrementer : decrementer,
+                            "decrementer");
+    count = create_threads(threads, max_threads, count, num_readers,
+                            kernels ? kernels->reader : reader, "reader");
+
+    if (run_until_stopped) {
+        struct timespec duration = {
+            .tv_sec = duration_ms / 1000,
+            .tv_nsec = duration_ms % 1000 * (NSEC_PER_SEC / 1000)
+        };
+        while (nanosleep(&duration, &duration) != 0) {
+            /* Interrupted; sleep for the remainder */
+        }
+        stop_threads();
+    }
+
+    /* Wait for all the threads to finish execution. */
+    join_threads(threads, count);
+}
+
+/**
+ * @brief   Runs worker threads for a fixed time under the current options
+ *          and measures them.
+ * 
+ * @details Gives the run fresh counter slots with latency timing, and its
+ *          own owner thread in delegation mode.
+ * 
+ * @param   num_incrementers Incrementer threads to create.
+ * @param   num_decrementers Decrementer threads to create.
+ * @param   num_readers      Reader threads to create.
+ * @param   duration_ms      How long to run.
+ * @param   result           Receives the throughput and tail latency.
+ */
+void measure_workers(int num_incrementers, int num_decrementers,
+                     int num_readers, long duration_ms, Measurement* result)
+{
+    int threads = num_incrementers + num_decrementers + num_readers;
+    StatsTotals totals;
+
+    stats_init(threads, 1);
+    if (get_options()->writer_lock == WRITER_LOCK_DELEGATE) {
+        start_delegation(threads);
+    }
+
+    long start = monotonic_ns();
+    run_workers(num_incrementers, num_decrementers, num_readers, duration_ms);
+    long elapsed = monotonic_ns() - start;
+    stop_delegation();
+
+    stats_totals(&totals);
+    result->throughput = (totals.ops[0] + totals.ops[1] + totals.ops[2]) *
+                         (double)NSEC_PER_SEC / elapsed;
+    result->tail_ns = stats_percentile(&totals, TAIL_PERCENTILE);
+    destroy_stats();
+}
+
+/**
+ * @brief   Prepares the process for a series of calibration runs.
+ * 
+ * @param   max_threads Most threads any of the runs will use.
+ */
+void begin_calibration(int max_threads)
+{
+    get_options()->quiet = 1;
+    alloc_threads(max_threads);
+    wal_pause(1);
+    history_pause(1);
+}
+
+/**
+ * @brief   Resumes logging and history recording after calibration runs.
+ */
+void end_calibration()
+{
+    wal_pause(0);
+    history_pause(0);
+}
+
 /* end thread_operations.c */
@@ -14,8 +14,53 @@
 #define THREAD_OPERATIONS_H
 
 #include <pthread.h>
+#include <time.h>
 #include "shared_data.h"
 
+/**
+ * @brief   Reads the shared sum using the readers protocol.
+ * 
+ * @param   id ID of the reading thread.
+ * @return  The value read.
+ */
+int read_operation(int id);
+
+/**
+ * @brief   Adjusts the shared sum using the writers protocol.
+ * 
+ * @details Does not wait for the change to be logged durably; follow up
+ *          with wal_sync() when persistence is enabled.
+ * 
+ * @param   increment Value to add to the sum (INCR_OP or DECR_OP).
+ * @param   id        ID of the writing thread.
+ * @return  The sum after the write.
+ */
+int write_operation(int increment, int id);
+
+/**
+ * @brief   Reads the shared sum, giving up if the locks cannot be acquired
+ *          before a deadline.
+ * 
+ * @param   id       ID of the reading thread.
+ * @param   deadline Absolute CLOCK_REALTIME deadline, or NULL for none.
+ * @param   value    Receives the value read.
+ * @return  OP_OK, or OP_TIMEOUT if the deadline passed first.
+ */
+int timed_read_operation(int id, const struct timespec* deadline, int* value);
+
+/**
+ * @brief   Adjusts the shared sum, giving up if the locks cannot be acquired
+ *          before a deadline.
+ * 
+ * @param   increment Value to add to the sum (INCR_OP or DECR_OP).
+ * @param   id        ID of the writing thread.
+ * @param   deadline  Absolute CLOCK_REALTIME deadline, or NULL for none.
+ * @param   value     Receives the sum after the write.
+ * @return  OP_OK, or OP_TIMEOUT if the deadline passed first.
+ */
+int timed_write_operation(int increment, int id,
+                          const struct timespec* deadline, int* value);
+
 /**
  * @brief   Thread function to increment the shared data sum by 1.
  * 
@@ -40,6 +85,62 @@ void* decrementer(void* arg);
  */
 void* reader(void* arg);
 
+/**
+ * @brief   Asks threads in a timed run to finish their current operation
+ *          and exit.
+ */
+void stop_threads();
+
+/**
+ * @struct  Measurement
+ *
+ * @brief   Throughput and tail latency of one timed run.
+ */
+typedef struct {
+    double throughput;          /* Completed operations per second      */
+    long tail_ns;               /* TAIL_PERCENTILE operation latency    */
+} Measurement;
+
+/**
+ * @brief   Runs a full set of worker threads and waits for them to finish.
+ * 
+ * @param   num_incrementers Incrementer threads to create.
+ * @param   num_decrementers Decrementer threads to create.
+ * @param   num_readers      Reader threads to create.
+ * @param   duration_ms      How long to run, or 0 to run every operation.
+ */
+void run_workers(int num_incrementers, int num_decrementers, int num_readers,
+                 long duration_ms);
+
+/**
+ * @brief   Runs worker threads for a fixed time under the current options
+ *          and measures them.
+ * 
+ * @param   num_incrementers Incrementer threads to create.
+ * @param   num_decrementers Decrementer threads to create.
+ * @param   num_readers      Reader threads to create.
+ * @param   duration_ms      How long to run.
+ * @param   result           Receives the throughput and tail latency.
+ */
+void measure_workers(int num_incrementers, int num_decrementers,
+                     int num_readers, long duration_ms, Measurement* result);
+
+/**
+ * @brief   Prepares the process for a series of calibration runs.
+ * 
+ * @details Calibration runs are silent, reuse one thread array and keep
+ *          their writes out of the write-ahead log and the history, so
+ *          their results do not depend on -p or -H.
+ * 
+ * @param   max_threads Most threads any of the runs will use.
+ */
+void begin_calibration(int max_threads);
+
+/**
+ * @brief   Resumes logging and history recording after calibration runs.
+ */
+void end_calibration();
+
 /**
  * @brief   Creates a specified number of threads of a certain type.
  * 
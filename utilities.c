@@ -6,53 +6,66 @@
  * 
  * @brief   Utility functions for the program.
  * 
- * @details Contains functions for handling errors, cleanup, mutex 
- *          locking/unlocking, and semaphore locking/unlocking.
+ * @details Contains functions for handling errors, cleanup, deadlines and
+ *          timed semaphore locking. The plain lock wrappers are inlined
+ *          from utilities.h.
  */
 
+#define _GNU_SOURCE             /* sem_clockwait() */
+
+#include <errno.h>
 #include "common.h"
 #include "resources.h"
 #include "utilities.h"
 #include "shared_data.h"
 
 /**
- * @brief   Locks the provided mutex.
+ * @brief   Locks the provided semaphore, giving up at a deadline.
  * 
- * @param   mutex Pointer to the mutex to be locked.
- */
-void mutex_lock(pthread_mutex_t *mutex)
-{
-    pthread_mutex_lock(mutex);
-}
-
-/**
- * @brief   Unlocks the provided mutex.
+ * @details Retries if interrupted by a signal before the deadline.
+ * 
+ * @param   semaphore Pointer to the semaphore to be locked.
+ * @param   deadline  Absolute CLOCK_MONOTONIC time to give up at.
  * 
- * @param   mutex Pointer to the mutex to be unlocked.
+ * @return  1 if the semaphore was locked, 0 if the deadline passed.
  */
-void mutex_unlock(pthread_mutex_t *mutex)
+int sem_lock_timed(sem_t *semaphore, const struct timespec *deadline)
 {
-    pthread_mutex_unlock(mutex);
+    while (sem_clockwait(semaphore, CLOCK_MONOTONIC, deadline) != 0) {
+        if (errno != EINTR) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
 /**
- * @brief   Locks the provided semaphore.
+ * @brief   Computes a deadline a given time from now.
  * 
- * @param   semaphore Pointer to the semaphore to be locked.
+ * @param   deadline Receives the absolute CLOCK_MONOTONIC deadline.
+ * @param   usec     Microseconds from now.
  */
-void sem_lock(sem_t *semaphore)
+void deadline_after(struct timespec *deadline, long usec)
 {
-    sem_wait(semaphore);
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_nsec += (usec % USEC_PER_SEC) * NSEC_PER_USEC;
+    deadline->tv_sec += usec / USEC_PER_SEC + deadline->tv_nsec / NSEC_PER_SEC;
+    deadline->tv_nsec %= NSEC_PER_SEC;
 }
 
 /**
- * @brief   Unlocks the provided semaphore.
+ * @brief   Checks whether a deadline has passed.
+ * 
+ * @param   deadline Absolute CLOCK_MONOTONIC deadline.
  * 
- * @param   semaphore Pointer to the semaphore to be unlocked.
+ * @return  1 if the deadline has passed, 0 otherwise.
  */
-void sem_unlock(sem_t *semaphore)
+int deadline_passed(const struct timespec *deadline)
 {
-    sem_post(semaphore);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
 }
 
 /**
@@ -8,38 +8,95 @@
  * 
  * @details Provides declarations for utility functions like error 
  *          handling, mutex operations, semaphore operations, and cleanup.
+ *          The untimed lock wrappers sit on every operation's hot path, so
+ *          they are defined here to be inlined into their callers.
  */
 
 #ifndef UTILITIES_H
 #define UTILITIES_H
 
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
 /**
  * @brief   Locks the provided mutex.
  * 
  * @param   mutex Pointer to the mutex to be locked.
  */
-void mutex_lock(pthread_mutex_t *mutex);
+static inline void mutex_lock(pthread_mutex_t *mutex)
+{
+    pthread_mutex_lock(mutex);
+}
 
 /**
  * @brief   Unlocks the provided mutex.
  * 
  * @param   mutex Pointer to the mutex to be unlocked.
  */
-void mutex_unlock(pthread_mutex_t *mutex);
+static inline void mutex_unlock(pthread_mutex_t *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
 
 /**
  * @brief   Locks the provided semaphore.
  * 
  * @param   semaphore Pointer to the semaphore to be locked.
  */
-void sem_lock(sem_t *semaphore);
+static inline void sem_lock(sem_t *semaphore)
+{
+    sem_wait(semaphore);
+}
+
+/**
+ * @brief   Locks the provided semaphore if it is immediately available.
+ * 
+ * @param   semaphore Pointer to the semaphore to be locked.
+ * 
+ * @return  1 if the semaphore was locked, 0 otherwise.
+ */
+static inline int sem_try_lock(sem_t *semaphore)
+{
+    return sem_trywait(semaphore) == 0;
+}
 
 /**
  * @brief   Unlocks the provided semaphore.
  * 
  * @param   semaphore Pointer to the semaphore to be unlocked.
  */
-void sem_unlock(sem_t *semaphore);
+static inline void sem_unlock(sem_t *semaphore)
+{
+    sem_post(semaphore);
+}
+
+/**
+ * @brief   Locks the provided semaphore, giving up at a deadline.
+ * 
+ * @param   semaphore Pointer to the semaphore to be locked.
+ * @param   deadline  Absolute CLOCK_MONOTONIC time to give up at.
+ * 
+ * @return  1 if the semaphore was locked, 0 if the deadline passed.
+ */
+int sem_lock_timed(sem_t *semaphore, const struct timespec *deadline);
+
+/**
+ * @brief   Computes a deadline a given time from now.
+ * 
+ * @param   deadline Receives the absolute CLOCK_MONOTONIC deadline.
+ * @param   usec     Microseconds from now.
+ */
+void deadline_after(struct timespec *deadline, long usec);
+
+/**
+ * @brief   Checks whether a deadline has passed.
+ * 
+ * @param   deadline Absolute CLOCK_MONOTONIC deadline.
+ * 
+ * @return  1 if the deadline has passed, 0 otherwise.
+ */
+int deadline_passed(const struct timespec *deadline);
 
 /**
  * @brief   Performs cleanup of resources and shared data.
@@ -0,0 +1,441 @@
+/**
+ * @file    wal.c
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Implements the write-ahead log with group commit.
+ *
+ * @details Appenders copy records into an in-memory buffer under a mutex.
+ *          Whoever needs durability and finds no flush in progress swaps the
+ *          buffer out and, without holding the mutex, writes and fsyncs it
+ *          as one batch. The flushing thread also applies the batch to a
+ *          private image of the durable state, so a checkpoint never needs
+ *          to stop the writers. Checkpoints alternate between two slots of
+ *          a memory-mapped file so a torn checkpoint never hides the last
+ *          good one.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "common.h"
+#include "utilities.h"
+#include "shared_data.h"
+#include "wal.h"
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+/**
+ * @struct  WalRecord
+ *
+ * @brief   One logged change, as stored on disk.
+ */
+typedef struct {
+    uint64_t lsn;           /* Log sequence number                      */
+    int32_t type;           /* INCR_OP, DECR_OP or WAL_PAIR             */
+    int32_t id;             /* Writer ID, or incrementer of a pair      */
+    int32_t partner_id;     /* Decrementer of a pair                    */
+    uint32_t check;         /* Checksum of the fields above             */
+} WalRecord;
+
+/**
+ * @struct  CheckpointSlot
+ *
+ * @brief   Snapshot of the durable state up to a log sequence number.
+ */
+typedef struct {
+    uint64_t lsn;           /* Last record included in the snapshot     */
+    SharedData state;       /* State after applying that record         */
+    uint32_t check;         /* Checksum of the fields above             */
+} CheckpointSlot;
+
+/**
+ * @struct  CheckpointFile
+ *
+ * @brief   Layout of the memory-mapped checkpoint file.
+ */
+typedef struct {
+    CheckpointSlot slots[2];
+} CheckpointFile;
+
+/**
+ * @struct  Wal
+ *
+ * @brief   State of the open log.
+ */
+typedef struct {
+    int log_fd;                 /* Log file, or -1 when disabled         */
+    int paused;                 /* Set while appends are ignored         */
+    int ckpt_fd;                /* Checkpoint file                       */
+    CheckpointFile* ckpt;       /* Mapped checkpoint file                */
+    int ckpt_next;              /* Checkpoint slot to write next         */
+    pthread_mutex_t mutex;      /* Protects the buffer and LSN counters  */
+    pthread_cond_t flushed;     /* Signalled after each group commit     */
+    WalRecord buffers[2][WAL_BUFFER_RECORDS];
+    WalRecord* active;          /* Buffer being appended to              */
+    WalRecord* standby;         /* Buffer being flushed, or idle         */
+    int count;                  /* Records in the active buffer          */
+    int flushing;               /* Set while a leader is flushing        */
+    uint64_t next_lsn;          /* LSN of the next appended record       */
+    uint64_t durable_lsn;       /* Every record up to here is on disk    */
+    uint64_t image_lsn;         /* Last record applied to the image      */
+    SharedData image;           /* Durable state, owned by the leader    */
+    unsigned long since_ckpt;   /* Durable records since last checkpoint */
+    unsigned long records;      /* Records made durable this run         */
+    unsigned long commits;      /* Group commits this run                */
+} Wal;
+
+static Wal wal = {
+    .log_fd = -1,
+    .ckpt_fd = -1,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .flushed = PTHREAD_COND_INITIALIZER
+};
+
+/**
+ * @brief   Computes an FNV-1a checksum.
+ *
+ * @param   bytes Data to checksum.
+ * @param   len   Length of the data.
+ *
+ * @return  The checksum.
+ */
+static uint32_t checksum(const void* bytes, size_t len)
+{
+    const unsigned char* p = bytes;
+    uint32_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief   Reports a failed system call on a log file and exits.
+ *
+ * @param   what Description of the failed operation.
+ */
+static void wal_error(const char* what)
+{
+    char errorMsg[PATH_MAX + MAX_STRING];
+    if (snprintf(errorMsg, sizeof(errorMsg), "Write-ahead log: %s: %s",
+                 what, strerror(errno)) >= (int)sizeof(errorMsg)) {
+        handle_error("Write-ahead log: error message too long");
+    }
+    handle_error(errorMsg);
+}
+
+/**
+ * @brief   Applies a logged change to a state image.
+ *
+ * @param   state  State to update.
+ * @param   record Change to apply.
+ */
+static void apply_record(SharedData* state, const WalRecord* record)
+{
+    if (record->type == WAL_PAIR) {
+        state->last_incr_id = record->id;
+        state->last_decr_id = record->partner_id;
+        state->num_writers += 2;
+        return;
+    }
+    state->sum += record->type;
+    if (record->type == INCR_OP) {
+        state->last_incr_id = record->id;
+    } else {
+        state->last_decr_id = record->id;
+    }
+    state->num_writers++;
+}
+
+/**
+ * @brief   Writes a checkpoint of the durable image and truncates the log.
+ *
+ * @details The checkpoint is made durable before the log is truncated, so
+ *          a crash in between only leaves records that recovery skips.
+ *          Only the flushing leader calls this, so the log is not being
+ *          written concurrently.
+ */
+static void write_checkpoint()
+{
+    CheckpointSlot* slot = &wal.ckpt->slots[wal.ckpt_next];
+
+    slot->lsn = wal.image_lsn;
+    slot->state = wal.image;
+    slot->check = checksum(slot, offsetof(CheckpointSlot, check));
+    if (msync(wal.ckpt, sizeof(CheckpointFile), MS_SYNC) != 0) {
+        wal_error("syncing checkpoint");
+    }
+    wal.ckpt_next ^= 1;
+
+    if (ftruncate(wal.log_fd, 0) != 0) {
+        wal_error("truncating log");
+    }
+    wal.since_ckpt = 0;
+}
+
+/**
+ * @brief   Writes out the active buffer as one group commit.
+ *
+ * @details Called with the mutex held. The mutex is released while the
+ *          batch is written so that other writers can keep appending to
+ *          the other buffer.
+ */
+static void flush_locked()
+{
+    WalRecord* batch = wal.active;
+    int count = wal.count;
+
+    if (count == 0) {
+        return;
+    }
+    wal.active = wal.standby;
+    wal.standby = batch;
+    wal.count = 0;
+    wal.flushing = 1;
+    mutex_unlock(&wal.mutex);
+
+    /* One write and one fsync for the whole batch */
+    size_t len = count * sizeof(WalRecord);
+    if (write(wal.log_fd, batch, len) != (ssize_t)len) {
+        wal_error("writing log");
+    }
+    if (fdatasync(wal.log_fd) != 0) {
+        wal_error("syncing log");
+    }
+    for (int i = 0; i < count; i++) {
+        apply_record(&wal.image, &batch[i]);
+    }
+    wal.image_lsn = batch[count - 1].lsn;
+    wal.since_ckpt += count;
+    if (wal.since_ckpt >= WAL_CHECKPOINT_RECORDS) {
+        write_checkpoint();
+    }
+
+    mutex_lock(&wal.mutex);
+    wal.durable_lsn = wal.image_lsn;
+    wal.records += count;
+    wal.commits++;
+    wal.flushing = 0;
+    pthread_cond_broadcast(&wal.flushed);
+}
+
+/**
+ * @brief   Opens a file named by a path prefix and suffix.
+ *
+ * @param   path   Path prefix.
+ * @param   suffix File name suffix.
+ * @param   flags  Extra open flags.
+ *
+ * @return  The file descriptor.
+ */
+static int open_file(const char* path, const char* suffix, int flags)
+{
+    char name[PATH_MAX];
+    if (snprintf(name, sizeof(name), "%s%s", path, suffix) >=
+            (int)sizeof(name)) {
+        handle_error("Write-ahead log path is too long");
+    }
+
+    int fd = open(name, O_RDWR | O_CREAT | flags, 0644);
+    if (fd < 0) {
+        wal_error(name);
+    }
+    return fd;
+}
+
+/**
+ * @brief   Maps the checkpoint file and loads its newest valid slot.
+ *
+ * @param   path Path prefix for the checkpoint file.
+ */
+static void load_checkpoint(const char* path)
+{
+    wal.ckpt_fd = open_file(path, WAL_CHECKPOINT_SUFFIX, 0);
+    if (ftruncate(wal.ckpt_fd, sizeof(CheckpointFile)) != 0) {
+        wal_error("sizing checkpoint");
+    }
+    wal.ckpt = mmap(NULL, sizeof(CheckpointFile), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, wal.ckpt_fd, 0);
+    if (wal.ckpt == MAP_FAILED) {
+        wal_error("mapping checkpoint");
+    }
+
+    /* Start from an empty state, as init_shared_data() does */
+    wal.image = *get_shared_data();
+    wal.image_lsn = 0;
+
+    for (int i = 0; i < 2; i++) {
+        CheckpointSlot* slot = &wal.ckpt->slots[i];
+        if (slot->lsn > wal.image_lsn &&
+            slot->check == checksum(slot, offsetof(CheckpointSlot, check))) {
+            wal.image_lsn = slot->lsn;
+            wal.image = slot->state;
+            wal.ckpt_next = i ^ 1;
+        }
+    }
+}
+
+/**
+ * @brief   Replays log records newer than the checkpoint.
+ *
+ * @details Stops at the first torn or corrupt record and truncates the log
+ *          there, since nothing after it was acknowledged as durable.
+ */
+static void replay_log()
+{
+    WalRecord record;
+    off_t valid_end = 0;
+
+    while (read(wal.log_fd, &record, sizeof(record)) == sizeof(record)) {
+        if (record.check != checksum(&record, offsetof(WalRecord, check))) {
+            break;
+        }
+        if (record.lsn > wal.image_lsn) {
+            apply_record(&wal.image, &record);
+            wal.image_lsn = record.lsn;
+        }
+        valid_end += sizeof(record);
+    }
+    if (ftruncate(wal.log_fd, valid_end) != 0) {
+        wal_error("truncating torn log tail");
+    }
+}
+
+/**
+ * @brief   Opens the log, recovers the persisted state and installs it.
+ *
+ * @param   path Path prefix for the log and checkpoint files.
+ */
+void wal_open(const char* path)
+{
+    load_checkpoint(path);
+    /* Appending keeps writes at the end even after the log is truncated */
+    wal.log_fd = open_file(path, WAL_LOG_SUFFIX, O_APPEND);
+    replay_log();
+
+    wal.active = wal.buffers[0];
+    wal.standby = wal.buffers[1];
+    wal.count = 0;
+    wal.durable_lsn = wal.image_lsn;
+    wal.next_lsn = wal.image_lsn + 1;
+
+    /* Resume from the recovered state */
+    *get_shared_data() = wal.image;
+}
+
+/**
+ * @brief   Appends a change record to the log buffer.
+ *
+ * @param   type       INCR_OP, DECR_OP or WAL_PAIR.
+ * @param   thread_id  ID of the writing thread (the incrementer of a pair).
+ * @param   partner_id ID of the decrementer of a pair, otherwise unused.
+ */
+void wal_append(int type, int thread_id, int partner_id)
+{
+    if (wal.log_fd < 0 || wal.paused) {
+        return;
+    }
+    mutex_lock(&wal.mutex);
+
+    /* A full buffer is flushed by whoever finds it full */
+    while (wal.count == WAL_BUFFER_RECORDS) {
+        if (wal.flushing) {
+            pthread_cond_wait(&wal.flushed, &wal.mutex);
+        } else {
+            flush_locked();
+        }
+    }
+
+    WalRecord* record = &wal.active[wal.count++];
+    record->lsn = wal.next_lsn++;
+    record->type = type;
+    record->id = thread_id;
+    record->partner_id = partner_id;
+    record->check = checksum(record, offsetof(WalRecord, check));
+
+    mutex_unlock(&wal.mutex);
+}
+
+/**
+ * @brief   Waits until every record appended so far is durable.
+ */
+void wal_sync()
+{
+    if (wal.log_fd < 0 || wal.paused) {
+        return;
+    }
+    mutex_lock(&wal.mutex);
+
+    uint64_t target = wal.next_lsn - 1;
+    while (wal.durable_lsn < target) {
+        if (wal.flushing) {
+            pthread_cond_wait(&wal.flushed, &wal.mutex);
+        } else {
+            flush_locked();
+        }
+    }
+
+    mutex_unlock(&wal.mutex);
+}
+
+/**
+ * @brief   Flushes the log, writes a final checkpoint and closes the files.
+ */
+void wal_close()
+{
+    if (wal.log_fd < 0) {
+        return;
+    }
+    wal_sync();
+    write_checkpoint();
+
+    munmap(wal.ckpt, sizeof(CheckpointFile));
+    close(wal.ckpt_fd);
+    close(wal.log_fd);
+    wal.log_fd = -1;
+    wal.ckpt_fd = -1;
+}
+
+/**
+ * @brief   Stops or resumes logging without closing the log.
+ *
+ * @param   paused 1 to pause logging, 0 to resume it.
+ */
+void wal_pause(int paused)
+{
+    wal.paused = paused;
+}
+
+/**
+ * @brief   Reports whether persistence is enabled.
+ *
+ * @return  1 if a log is open, 0 otherwise.
+ */
+int wal_enabled()
+{
+    return wal.log_fd >= 0;
+}
+
+/**
+ * @brief   Retrieves group commit statistics.
+ *
+ * @param   records Receives the number of records made durable this run.
+ * @param   commits Receives the number of group commits this run.
+ */
+void wal_stats(unsigned long* records, unsigned long* commits)
+{
+    mutex_lock(&wal.mutex);
+    *records = wal.records;
+    *commits = wal.commits;
+    mutex_unlock(&wal.mutex);
+}
+
+/* end wal.c */
@@ -0,0 +1,88 @@
+/**
+ * @file    wal.h
+ * @author  Kieran Hillier
+ * @date    October 18, 2026
+ * @version 1.0
+ *
+ * @brief   Declares the write-ahead log used to persist the shared data.
+ *
+ * @details Every change to the shared data is appended to a log. Writers
+ *          commit in groups, so one write and fsync makes a whole batch of
+ *          records durable. The durable state is periodically checkpointed
+ *          to a memory-mapped file, after which the log is truncated.
+ *          Startup recovery loads the checkpoint and replays the log tail.
+ */
+
+#ifndef WAL_H
+#define WAL_H
+
+#define WAL_PAIR 2                  /* Record type for eliminated pairs     */
+#define WAL_BUFFER_RECORDS 1024     /* Records buffered per group commit    */
+#define WAL_CHECKPOINT_RECORDS 8192 /* Durable records between checkpoints  */
+#define WAL_LOG_SUFFIX ".log"
+#define WAL_CHECKPOINT_SUFFIX ".ckpt"
+
+/**
+ * @brief   Opens the log, recovers the persisted state and installs it.
+ *
+ * @details Loads the newest valid checkpoint, replays any later log records
+ *          into it and copies the result into the shared data, which must
+ *          already be initialized.
+ *
+ * @param   path Path prefix for the log and checkpoint files.
+ */
+void wal_open(const char* path);
+
+/**
+ * @brief   Appends a change record to the log buffer.
+ *
+ * @details Does nothing when persistence is disabled. Records are assigned
+ *          log sequence numbers in the order they are appended, which must
+ *          be the order the changes are applied in.
+ *
+ * @param   type       INCR_OP, DECR_OP or WAL_PAIR.
+ * @param   thread_id  ID of the writing thread (the incrementer of a pair).
+ * @param   partner_id ID of the decrementer of a pair, otherwise unused.
+ */
+void wal_append(int type, int thread_id, int partner_id);
+
+/**
+ * @brief   Waits until every record appended so far is durable.
+ *
+ * @details The first waiter to find no flush in progress becomes the leader
+ *          and writes out the whole buffered batch with a single write and
+ *          fsync on behalf of all waiters.
+ */
+void wal_sync();
+
+/**
+ * @brief   Flushes the log, writes a final checkpoint and closes the files.
+ */
+void wal_close();
+
+/**
+ * @brief   Stops or resumes logging without closing the log.
+ *
+ * @details While paused, appends and syncs are ignored. Must only be
+ *          called while no writers are running.
+ *
+ * @param   paused 1 to pause logging, 0 to resume it.
+ */
+void wal_pause(int paused);
+
+/**
+ * @brief   Reports whether persistence is enabled.
+ *
+ * @return  1 if a log is open, 0 otherwise.
+ */
+int wal_enabled();
+
+/**
+ * @brief   Retrieves group commit statistics.
+ *
+ * @param   records Receives the number of records made durable this run.
+ * @param   commits Receives the number of group commits this run.
+ */
+void wal_stats(unsigned long* records, unsigned long* commits);
+
+#endif /* WAL_H */